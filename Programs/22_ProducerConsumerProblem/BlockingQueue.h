@@ -12,7 +12,7 @@
 #include <utility>             // for std::move
 #include <queue>               // for std::queue
 
-namespace ProducerConsumerQueue
+namespace ProducerConsumerQueue::ConditionVariables
 {
     template<typename T, std::size_t QueueSize = 10>
     class BlockingQueue
@@ -55,7 +55,7 @@ namespace ProducerConsumerQueue
                 // push item
                 m_data.push(item);
 
-                Logger::log(std::cout, "    Size: ", m_data.size());
+                Logger::trace(std::cout, "    Size: ", m_data.size());
             }
 
             // wakeup any sleeping consumers
@@ -76,7 +76,7 @@ namespace ProducerConsumerQueue
                 // push moved item
                 m_data.push(std::move(item));
 
-                Logger::log(std::cout, "    Size: ", m_data.size());
+                Logger::trace(std::cout, "    Size: ", m_data.size());
             }
 
             // wakeup any sleeping consumers
@@ -98,13 +98,93 @@ namespace ProducerConsumerQueue
                 item = std::move(m_data.front());
                 m_data.pop();
 
-                Logger::log(std::cout, "    Size: ", m_data.size());
+                Logger::trace(std::cout, "    Size: ", m_data.size());
             }
 
             // wakeup any sleeping producers
             m_conditionIsFull.notify_all();
         }
 
+        // batch operations: as many elements as fit (or are available) are moved
+        // under one lock, followed by a single notification.
+        // Elements of the range are copied - use std::make_move_iterator to move them
+        template<typename TInputIt>
+        void push_range(TInputIt first, TInputIt last)
+        {
+            while (first != last)
+            {
+                {
+                    std::unique_lock<std::mutex> guard{ m_mutex };
+
+                    // wait until there's space for at least one item
+                    m_conditionIsFull.wait(
+                        guard,
+                        [this]() -> bool { return m_data.size() < QueueSize; }
+                    );
+
+                    // push as many items as fit
+                    while (first != last && m_data.size() < QueueSize) {
+                        m_data.push(*first);
+                        ++first;
+                    }
+
+                    Logger::trace(std::cout, "    Size: ", m_data.size());
+                }
+
+                // wakeup any sleeping consumers
+                m_conditionIsEmpty.notify_all();
+            }
+        }
+
+        // waits for at least one item, retrieves up to 'max' items - returns their number
+        template<typename TOutputIt>
+        std::size_t pop_n(TOutputIt out, std::size_t max)
+        {
+            if (max == 0) {
+                return 0;
+            }
+
+            std::size_t count{};
+
+            {
+                std::unique_lock<std::mutex> guard{ m_mutex };
+
+                // wait until there's at least one item
+                m_conditionIsEmpty.wait(
+                    guard,
+                    [this]() -> bool { return !m_data.empty(); }
+                );
+
+                count = take(out, max);
+
+                Logger::trace(std::cout, "    Size: ", m_data.size());
+            }
+
+            // wakeup any sleeping producers
+            m_conditionIsFull.notify_all();
+
+            return count;
+        }
+
+        // doesn't wait: retrieves all items currently in the queue - returns their number
+        template<typename TOutputIt>
+        std::size_t drain(TOutputIt out)
+        {
+            std::size_t count{};
+
+            {
+                std::lock_guard<std::mutex> guard{ m_mutex };
+                count = take(out, m_data.size());
+            }
+
+            if (count != 0) {
+                // wakeup any sleeping producers
+                m_conditionIsFull.notify_all();
+            }
+
+            return count;
+        }
+
         bool empty() const
         {
             std::lock_guard<std::mutex> guard{ m_mutex };
@@ -116,9 +196,33 @@ namespace ProducerConsumerQueue
             std::lock_guard<std::mutex> guard{ m_mutex };
             return m_data.size();
         }
+
+    private:
+        // requires m_mutex
+        template<typename TOutputIt>
+        std::size_t take(TOutputIt& out, std::size_t max)
+        {
+            std::size_t count{};
+
+            while (count != max && !m_data.empty()) {
+                *out = std::move(m_data.front());
+                ++out;
+                m_data.pop();
+                ++count;
+            }
+
+            return count;
+        }
     };
 }
 
+// the default variant - the other ones are used by their qualified names
+namespace ProducerConsumerQueue
+{
+    template<typename T, std::size_t QueueSize = 10>
+    using BlockingQueue = ConditionVariables::BlockingQueue<T, QueueSize>;
+}
+
 // ===========================================================================
 // End-of-File
 // ===========================================================================
@@ -13,7 +13,7 @@
 #include <utility>   // for std::move
 #include <cstddef>   // for std::size_t
 
-namespace ProducerConsumerQueue
+namespace ProducerConsumerQueue::Semaphores
 {
     template<typename T, std::size_t QueueSize = 10>
     class BlockingQueue
@@ -33,12 +33,12 @@ namespace ProducerConsumerQueue
     public:
         // default c'tor
         BlockingQueue() :
+            m_data{ static_cast<T*>(std::malloc(sizeof(T) * QueueSize)) },
             m_size{},
             m_pushIndex{},
             m_popIndex{},
             m_emptySlots{ QueueSize },
-            m_fullSlots{ 0 },
-            m_data{ static_cast<T*>(std::malloc(sizeof(T) * QueueSize)) }
+            m_fullSlots{ 0 }
         {
             Logger::log(std::cout, "Using Blocking Queue with Semaphores");
         }
@@ -80,7 +80,7 @@ namespace ProducerConsumerQueue
 
                 ++m_size;
 
-                Logger::log(std::cout, "    Size: ", m_size);
+                Logger::trace(std::cout, "    Size: ", m_size);
             }
             m_fullSlots.release();
         }
@@ -98,7 +98,7 @@ namespace ProducerConsumerQueue
 
                 ++m_size;
 
-                Logger::log(std::cout, "    Size: ", m_size);
+                Logger::trace(std::cout, "    Size: ", m_size);
             }
             m_fullSlots.release();
         }
@@ -117,7 +117,7 @@ namespace ProducerConsumerQueue
 
                 --m_size;
 
-                Logger::log(std::cout, "    Size: ", m_size);
+                Logger::trace(std::cout, "    Size: ", m_size);
             }
             m_emptySlots.release();
         }
@@ -135,6 +135,7 @@ namespace ProducerConsumerQueue
         }
     };
 }
+
 // ===========================================================================
 // End-of-File
 // ===========================================================================
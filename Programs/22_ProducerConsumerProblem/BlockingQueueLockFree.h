@@ -0,0 +1,235 @@
+// ===========================================================================
+// BlockingQueueLockFree.h
+// ===========================================================================
+
+#pragma once
+
+#include "../Logger/Logger.h"
+
+#include <algorithm> // for std::max
+#include <atomic>    // for std::atomic
+#include <bit>       // for std::bit_ceil
+#include <cstddef>   // for std::size_t, std::ptrdiff_t
+#include <cstdint>   // for std::uint32_t
+#include <memory>    // for std::unique_ptr
+#include <new>       // for placement new, std::hardware_destructive_interference_size
+#include <utility>   // for std::move
+
+// Bounded multi-producer/multi-consumer ring buffer (Dmitry Vyukov):
+// every slot carries a sequence number, which tells producers and consumers
+// whether the slot is ready to be written or to be read. Producers and consumers
+// only contend on their own position counter (one CAS per operation), no mutex.
+// A thread blocks only if the ring is full (producer) or empty (consumer):
+// it registers itself as waiting and sleeps with std::atomic::wait on an event counter,
+// the other side bumps the counter and notifies - but only if somebody is waiting.
+// The capacity is QueueSize rounded up to the next power of two, at least 2:
+// with a single slot 'filled at position n' and 'free at position n + 1' would be the same sequence number.
+
+namespace ProducerConsumerQueue::LockFree
+{
+    template<typename T, std::size_t QueueSize = 10>
+    class BlockingQueue
+    {
+    private:
+        static constexpr std::size_t Capacity{ std::max<std::size_t>(2, std::bit_ceil(QueueSize)) };
+        static constexpr std::size_t Mask{ Capacity - 1 };
+        static constexpr std::size_t CacheLineSize{ std::hardware_destructive_interference_size };
+
+        struct Slot
+        {
+            std::atomic<std::size_t>   m_sequence;
+            alignas(T) unsigned char   m_storage[sizeof(T)];
+
+            T* item() { return std::launder(reinterpret_cast<T*>(m_storage)); }
+        };
+
+        // a side waiting for the other one: event counter and flag 'a thread is going to sleep'
+        struct alignas(CacheLineSize) Event
+        {
+            std::atomic<std::uint32_t>  m_counter{};
+            std::atomic<std::uint32_t>  m_waiting{};
+        };
+
+        std::unique_ptr<Slot[]>                           m_slots;
+        alignas(CacheLineSize) std::atomic<std::size_t>   m_enqueuePos;
+        alignas(CacheLineSize) std::atomic<std::size_t>   m_dequeuePos;
+        Event                                             m_notEmpty;   // consumers wait here
+        Event                                             m_notFull;    // producers wait here
+
+    public:
+        // default c'tor
+        BlockingQueue()
+            : m_slots{ new Slot[Capacity] }, m_enqueuePos{}, m_dequeuePos{}
+        {
+            for (std::size_t i{}; i != Capacity; ++i) {
+                m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+            }
+
+            Logger::log(std::cout, "Using Blocking Queue with a lock-free Ring Buffer");
+        }
+
+        // don't need other constructors or assignment operators
+        BlockingQueue(const BlockingQueue&) = delete;
+        BlockingQueue(BlockingQueue&&) = delete;
+
+        BlockingQueue& operator= (const BlockingQueue&) = delete;
+        BlockingQueue& operator= (BlockingQueue&&) = delete;
+
+        // destructor
+        ~BlockingQueue()
+        {
+            std::size_t pos{ m_dequeuePos.load(std::memory_order_relaxed) };
+            std::size_t end{ m_enqueuePos.load(std::memory_order_relaxed) };
+
+            for (; pos != end; ++pos) {
+                m_slots[pos & Mask].item()->~T();
+            }
+        }
+
+        // public interface
+        void push(const T& item)
+        {
+            pushItem(item);
+        }
+
+        void push(T&& item)
+        {
+            pushItem(std::move(item));
+        }
+
+        void pop(T& item)
+        {
+            while (!tryPop(item))
+            {
+                if (wait(m_notEmpty, [&] () { return tryPop(item); })) {
+                    break;
+                }
+            }
+        }
+
+        // non-blocking variants
+        template<typename TItem>
+        bool tryPush(TItem&& item)
+        {
+            std::size_t pos{ m_enqueuePos.load(std::memory_order_relaxed) };
+
+            while (true)
+            {
+                Slot& slot{ m_slots[pos & Mask] };
+                std::size_t sequence{ slot.m_sequence.load(std::memory_order_acquire) };
+                std::ptrdiff_t diff{ static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos) };
+
+                if (diff == 0) {
+                    // slot is free: claim it
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        ::new (slot.m_storage) T{ std::forward<TItem>(item) };
+                        slot.m_sequence.store(pos + 1, std::memory_order_release);
+                        signal(m_notEmpty);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;   // full
+                }
+                else {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool tryPop(T& item)
+        {
+            std::size_t pos{ m_dequeuePos.load(std::memory_order_relaxed) };
+
+            while (true)
+            {
+                Slot& slot{ m_slots[pos & Mask] };
+                std::size_t sequence{ slot.m_sequence.load(std::memory_order_acquire) };
+                std::ptrdiff_t diff{ static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1) };
+
+                if (diff == 0) {
+                    // slot is filled: claim it
+                    if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        T* stored{ slot.item() };
+                        item = std::move(*stored);
+                        stored->~T();
+                        slot.m_sequence.store(pos + Capacity, std::memory_order_release);
+                        signal(m_notFull);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;   // empty
+                }
+                else {
+                    pos = m_dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // approximate while other threads are active
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        std::size_t size() const
+        {
+            std::size_t enqueuePos{ m_enqueuePos.load(std::memory_order_relaxed) };
+            std::size_t dequeuePos{ m_dequeuePos.load(std::memory_order_relaxed) };
+            return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+        }
+
+    private:
+        template<typename TItem>
+        void pushItem(TItem&& item)
+        {
+            // 'item' is consumed by a successful tryPush only
+            while (!tryPush(std::forward<TItem>(item)))
+            {
+                if (wait(m_notFull, [&] () { return tryPush(std::forward<TItem>(item)); })) {
+                    break;
+                }
+            }
+
+            Logger::trace(std::cout, "    Size: ", size());
+        }
+
+        // registers as waiting, retries once, sleeps until the counter changes - returns true,
+        // if the retry succeeded. Sequentially consistent: either the retry sees the update
+        // of the other side, or the other side sees the registration and notifies
+        template<typename TRetry>
+        static bool wait(Event& event, TRetry retry)
+        {
+            std::uint32_t counter{ event.m_counter.load(std::memory_order_acquire) };
+
+            event.m_waiting.store(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (retry()) {
+                return true;
+            }
+
+            event.m_counter.wait(counter, std::memory_order_acquire);
+            return false;
+        }
+
+        // the first signal after a registration wakes all sleepers (they retry and register again),
+        // the following ones see no waiter and cost just the fence
+        static void signal(Event& event)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (event.m_waiting.load(std::memory_order_relaxed) != 0 &&
+                event.m_waiting.exchange(0, std::memory_order_relaxed) != 0)
+            {
+                event.m_counter.fetch_add(1, std::memory_order_release);
+                event.m_counter.notify_all();
+            }
+        }
+    };
+}
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
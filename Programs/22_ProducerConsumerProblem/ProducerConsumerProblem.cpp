@@ -2,10 +2,19 @@
 // ProducerConsumerProblem.cpp
 // ===========================================================================
 
+// ProducerConsumerQueue::BlockingQueue (tests 01 - 06) is the condition variable variant,
+// all variants are available in their own namespaces
 #include "BlockingQueue.h"
-// #include "BlockingQueueEx.h"
+#include "BlockingQueueEx.h"
+#include "BlockingQueueLockFree.h"
 
+#include "../Globals/QueueBenchmark.h"
+
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 constexpr int NumIterations{ 10 };
 
@@ -332,6 +341,48 @@ void test_thread_safe_blocking_queue_06()
 
 // ===========================================================================
 
+// throughput: condition variables vs. semaphores vs. lock-free ring buffer
+
+void test_thread_safe_blocking_queue_07()
+{
+    using namespace ProducerConsumerQueue;
+
+    constexpr std::size_t QueueSize{ 1024 };
+
+    constexpr std::pair<std::size_t, std::size_t> Ratios[]{ { 1, 1 }, { 4, 4 }, { 16, 16 } };
+
+    for (auto [producers, consumers] : Ratios)
+    {
+        QueueBenchmark::run<ConditionVariables::BlockingQueue<int, QueueSize>>("Condition Variables", producers, consumers);
+        QueueBenchmark::run<Semaphores::BlockingQueue<int, QueueSize>>("Semaphores         ", producers, consumers);
+        QueueBenchmark::run<LockFree::BlockingQueue<int, QueueSize>>("Lock-free          ", producers, consumers);
+    }
+}
+
+// ===========================================================================
+
+// batches: push_range / pop_n versus push / pop (condition variables)
+
+void test_thread_safe_blocking_queue_08()
+{
+    using Queue = ProducerConsumerQueue::ConditionVariables::BlockingQueue<int, 1024>;
+
+    QueueBenchmark::run<Queue, 1>("Condition Variables", 4, 4);
+    QueueBenchmark::run<Queue, 16>("Condition Variables", 4, 4);
+    QueueBenchmark::run<Queue, 64>("Condition Variables", 4, 4);
+
+    // drain: whatever is in the queue right now, without waiting
+    ProducerConsumerQueue::ConditionVariables::BlockingQueue<int, 10> queue{};
+
+    std::vector<int> values{ 1, 2, 3, 4, 5 };
+    queue.push_range(values.begin(), values.end());
+
+    std::vector<int> drained;
+    std::size_t count{ queue.drain(std::back_inserter(drained)) };
+
+    Logger::log(std::cout, "Drained ", count, " items, queue empty: ", queue.empty());
+}
+
 // ===========================================================================
 // End-of-File
 // ===========================================================================
@@ -8,6 +8,8 @@ void test_thread_safe_blocking_queue_03();   // passing BlockingQueue to separat
 void test_thread_safe_blocking_queue_04();   // testing BlockingQueue with 6 threads
 void test_thread_safe_blocking_queue_05();   // testing BlockingQueue with real objects
 void test_thread_safe_blocking_queue_06();   // testing BlockingQueue with 6 threads and Person objects
+void test_thread_safe_blocking_queue_07();   // throughput of the three BlockingQueue variants
+void test_thread_safe_blocking_queue_08();   // batches: push_range / pop_n versus push / pop
 
 static void test_producer_consumer_problem()
 {
@@ -17,6 +19,8 @@ static void test_producer_consumer_problem()
     test_thread_safe_blocking_queue_04();   // testing BlockingQueue with 6 threads
     //test_thread_safe_blocking_queue_05();   // testing BlockingQueue with real objects
     //test_thread_safe_blocking_queue_06();   // testing BlockingQueue with 6 threads and Person objects
+    //test_thread_safe_blocking_queue_07();   // throughput of the three BlockingQueue variants
+    //test_thread_safe_blocking_queue_08();   // batches: push_range / pop_n versus push / pop
 }
 
 int main()
@@ -4,11 +4,13 @@
 
 extern void test_thread_safe_queue_01();
 extern void test_thread_safe_queue_02();
+extern void test_thread_safe_queue_03();
 
 int main()
 {
     test_thread_safe_queue_01();  // just testing pop variants
     test_thread_safe_queue_02();  // testing concurrent access to a ThreadsafeQueue object
+    //test_thread_safe_queue_03();  // batches: push_range / pop_n versus push / waitAndPop
     return 0;
 }
 
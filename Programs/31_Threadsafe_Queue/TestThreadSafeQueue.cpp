@@ -5,8 +5,13 @@
 #include "../Logger/Logger.h"
 #include "ThreadsafeQueue.h"
 
+#include "../Globals/QueueBenchmark.h"
+
+#include <cstddef>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <vector>
 
 void test_thread_safe_queue_01()
 {
@@ -71,6 +76,30 @@ void test_thread_safe_queue_02()
     }
 }
 
+// ===========================================================================
+// batches: push_range / pop_n versus push / waitAndPop
+
+void test_thread_safe_queue_03()
+{
+    using namespace Concurrency_ThreadsafeQueue;
+
+    QueueBenchmark::run<ThreadsafeQueue<int>, 1>("ThreadsafeQueue", 4, 4);
+    QueueBenchmark::run<ThreadsafeQueue<int>, 16>("ThreadsafeQueue", 4, 4);
+    QueueBenchmark::run<ThreadsafeQueue<int>, 64>("ThreadsafeQueue", 4, 4);
+    QueueBenchmark::run<ThreadsafeQueue<int>, 256>("ThreadsafeQueue", 4, 4);
+
+    // drain: whatever is in the queue right now
+    ThreadsafeQueue<int> queue;
+
+    std::vector<int> values{ 1, 2, 3, 4, 5 };
+    queue.push_range(values.begin(), values.end());
+
+    std::vector<int> drained;
+    std::size_t count{ queue.drain(std::back_inserter(drained)) };
+
+    Logger::log(std::cout, "Drained ", count, " values, queue empty: ", queue.empty());
+}
+
 // ===========================================================================
 // End-of-File
 // ===========================================================================
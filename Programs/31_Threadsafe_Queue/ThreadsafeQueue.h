@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <condition_variable>
+#include <cstddef>
 #include <mutex>
 #include <optional>
 #include <queue>
@@ -71,6 +73,27 @@ namespace Concurrency_ThreadsafeQueue
             m_condition.notify_one();
         }
 
+        // the whole range under one lock, a single notification
+        // (move iterators move the elements into the queue)
+        template<typename TInputIt>
+        void push_range(TInputIt first, TInputIt last)
+        {
+            std::size_t count{};
+
+            std::unique_lock<std::mutex> guard{ m_mutex };
+            for (; first != last; ++first, ++count) {
+                m_data.push(*first);
+            }
+            guard.unlock();
+
+            if (count == 1) {
+                m_condition.notify_one();
+            }
+            else if (count > 1) {
+                m_condition.notify_all();
+            }
+        }
+
         bool tryPop(T& value)
         {
             std::lock_guard<std::mutex> guard{ m_mutex };
@@ -109,6 +132,52 @@ namespace Concurrency_ThreadsafeQueue
             m_data.pop();
         }
 
+        // waits for at least one element, retrieves up to 'max' elements - returns their number
+        template<typename TOutputIt>
+        std::size_t pop_n(TOutputIt out, std::size_t max)
+        {
+            if (max == 0) {
+                return 0;
+            }
+
+            std::unique_lock<std::mutex> guard{ m_mutex };
+            m_condition.wait(guard, [this]() {
+                return !m_data.empty();
+                }
+            );
+
+            std::size_t count{ std::min(max, m_data.size()) };
+
+            for (std::size_t i{}; i != count; ++i, ++out) {
+                *out = std::move(m_data.front());
+                m_data.pop();
+            }
+
+            return count;
+        }
+
+        // doesn't wait: takes over all elements currently in the queue with a swap,
+        // they are handed over to 'out' after the lock has been released - returns their number
+        template<typename TOutputIt>
+        std::size_t drain(TOutputIt out)
+        {
+            std::queue<T> data;
+
+            {
+                std::lock_guard<std::mutex> guard{ m_mutex };
+                data.swap(m_data);
+            }
+
+            std::size_t count{ data.size() };
+
+            for (; !data.empty(); ++out) {
+                *out = std::move(data.front());
+                data.pop();
+            }
+
+            return count;
+        }
+
         bool empty() const
         {
             std::lock_guard<std::mutex> guard{ m_mutex };
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "../Logger/Logger.h"
+#include "../Logger/TraceScope.h"
 
 #include "ParallelFor02.h"
 
@@ -23,6 +24,8 @@ namespace Concurrency_ParallelFor_Legacy
             Logger::log(std::cout, "TID: ", std::this_thread::get_id());
         }
 
+        TraceScope scope{ "parallel_for chunk" };
+
         callable(start, end);
     }
 
@@ -68,7 +71,7 @@ namespace Concurrency_ParallelFor_Legacy
 
         // take care of last element - calling 'callable' synchronously 
         std::size_t start{ from + (numThreads - 1) * batchSize };
-        callable(start, to);
+        callableWrapper(callable, start, to);
 
         // wait for the other thread to finish their task
         if (useThreads) {
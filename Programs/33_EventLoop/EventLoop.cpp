@@ -4,15 +4,75 @@
 
 #include "EventLoop.h"
 
+#include "../Logger/TraceScope.h"
+
+#if defined(EVENTLOOP_EPOLL)
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
 // default c'tor
-EventLoop::EventLoop() : m_running{ false } {}
+EventLoop::EventLoop()
+    : m_wakeups{}, m_parked{ Running }, m_running{ false },
+      m_epoll{ -1 }, m_wakeupFd{ -1 }, m_timerFd{ -1 }, m_armed{}
+{
+    m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeupFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m_timerFd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);   // steady_clock
+
+    if (m_epoll == -1 || m_wakeupFd == -1 || m_timerFd == -1) {
+        int error{ errno };
+        closeDescriptors();
+        throw std::system_error{ error, std::generic_category(), "EventLoop: creating epoll/eventfd/timerfd failed" };
+    }
+
+    for (int fd : { m_wakeupFd, m_timerFd })
+    {
+        ::epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+
+        ::epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event);
+    }
+}
 
 // d'tor
 EventLoop::~EventLoop()
 {
     stop();
+    closeDescriptors();
+}
+
+void EventLoop::closeDescriptors()
+{
+    for (int fd : { m_timerFd, m_wakeupFd, m_epoll }) {
+        if (fd != -1) {
+            ::close(fd);
+        }
+    }
 }
 
+#else
+
+// default c'tor
+EventLoop::EventLoop() : m_wakeups{}, m_parked{ Running }, m_running{ false } {}
+
+// d'tor
+EventLoop::~EventLoop()
+{
+    stop();
+}
+
+#endif
+
 void EventLoop::start()
 {
     m_running = true;
@@ -32,51 +92,329 @@ void EventLoop::stop()
 
 void EventLoop::enqueue(Event callable)
 {
+    m_inbox.push(std::move(callable));
+
+    wakeUp();
+}
+
+void EventLoop::wakeUp()
+{
+    // fast path: the loop thread is running, it will see the new event
+    if (m_parked.load() == Running) {
+        return;
+    }
+
+    // only the first producer wakes up the parked loop, the following ones take the fast path
+    std::uint32_t parked{ m_parked.exchange(Running) };
+
+    if (parked == Running) {
+        return;
+    }
+
+#if defined(EVENTLOOP_EPOLL)
+    // a single write: epoll_wait returns
+    std::uint64_t value{ 1 };
+    [[maybe_unused]] auto result{ ::write(m_wakeupFd, &value, sizeof(value)) };
+#else
+    m_wakeups.fetch_add(1);
+
+    if (parked == Waiting) {
+        m_wakeups.notify_one();
+    }
+    else {
+        // the loop checks m_wakeups while holding the mutex
+        { std::lock_guard<std::mutex> guard{ m_mutex }; }
+        m_condition.notify_one();
+    }
+#endif
+}
+
+TimerHandle EventLoop::addTimer(std::chrono::steady_clock::duration delay, std::chrono::steady_clock::duration period, Event callable)
+{
+    TimerId id{};
+
     {
         std::lock_guard<std::mutex> guard{ m_mutex };
 
-        m_events.push_back(std::move(callable));
+        id = m_timers.add(std::chrono::steady_clock::now() + delay, period, std::move(callable));
+
+        // event loop recalculates its waiting time - even if it is just about to park
+        m_wakeups.fetch_add(1);
     }
 
-    m_condition.notify_one();
+    wakeUp();
+
+    return TimerHandle{
+        this,
+        [] (void* loop, TimerId id) { return static_cast<EventLoop*>(loop)->cancelTimer(id); },
+        id
+    };
+}
+
+bool EventLoop::cancelTimer(TimerId id)
+{
+    std::lock_guard<std::mutex> guard{ m_mutex };
+
+    return m_timers.cancel(id);
 }
 
 void EventLoop::threadProcedure()
 {
+    Logger::setThreadName("event-loop");
+
     Logger::log(std::cout, "> Event Loop");
 
-    std::vector<Event> events;
+    std::vector<Event> expired;
 
     while (true)
     {
+        // read before looking at the inbox and the timers: any later change wakes up park
+        std::uint32_t wakeups{ m_wakeups.load() };
+
+        std::size_t count{ m_inbox.drain([] (Event& callable) {
+            Logger::trace(std::cout, "! invoking next event");
+            TraceScope scope{ "event" };
+            callable();
+        }) };
+
+        if (count != 0) {
+            Logger::trace(std::cout, "invoked ", count, " event(s) ...");
+        }
+
+        std::optional<std::chrono::steady_clock::time_point> deadline{};
+
         {
-            std::unique_lock<std::mutex> guard{ m_mutex };
+            std::lock_guard<std::mutex> guard{ m_mutex };
 
-            m_condition.wait(
-                guard,
-                [this] () -> bool { return ! m_events.empty() || !m_running; }
-            );
+            // expired timers are executed after the pending events
+            m_timers.advance(std::chrono::steady_clock::now(), [&expired] (Event callable) {
+                expired.push_back(std::move(callable));
+            });
 
-            if (!m_running && m_events.empty()) {
-                Logger::log(std::cout, "< Event Loop");
-                return;
+            if (!m_timers.empty()) {
+                deadline = m_timers.nextExpiry();
             }
+        }
+
+        for (auto& callable : expired)
+        {
+            Logger::trace(std::cout, "! invoking next event");
+            TraceScope scope{ "timer event" };
+            callable();
+        }
+
+        bool idle{ count == 0 && expired.empty() };
+
+        expired.clear();  // empty container for next loop
+
+        if (!m_running && m_inbox.empty()) {
+            Logger::log(std::cout, "< Event Loop");
+            return;
+        }
+
+        poll(idle, wakeups, deadline);
+    }
+}
+
+#if defined(EVENTLOOP_EPOLL)
+
+bool EventLoop::watchFd(int fd, std::uint32_t events, FdCallback callback)
+{
+    if (std::this_thread::get_id() == m_thread.get_id()) {
+        applyWatch(fd, events, std::move(callback));
+    }
+    else {
+        enqueue([this, fd, events, callback = std::move(callback)] () mutable {
+            applyWatch(fd, events, std::move(callback));
+        });
+    }
+
+    return true;
+}
+
+bool EventLoop::unwatchFd(int fd)
+{
+    if (std::this_thread::get_id() == m_thread.get_id()) {
+        applyUnwatch(fd);
+    }
+    else {
+        enqueue([this, fd] () { applyUnwatch(fd); });
+    }
+
+    return true;
+}
+
+void EventLoop::applyWatch(int fd, std::uint32_t events, FdCallback callback)
+{
+    ::epoll_event event{};
+    event.events = ((events & Readable) ? EPOLLIN : 0u) | ((events & Writable) ? EPOLLOUT : 0u);
+    event.data.fd = fd;
+
+    auto pos{ m_watchers.find(fd) };
+
+    if (pos == m_watchers.end())
+    {
+        if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+            Logger::log(std::cout, "watchFd: epoll_ctl failed for fd ", fd, ": ", std::strerror(errno));
+            return;
+        }
 
-            std::swap(events, m_events);
+        m_watchers.emplace(fd, std::make_unique<FdWatcher>(std::move(callback), events));
+    }
+    else
+    {
+        if (::epoll_ctl(m_epoll, EPOLL_CTL_MOD, fd, &event) != 0) {
+            Logger::log(std::cout, "watchFd: epoll_ctl failed for fd ", fd, ": ", std::strerror(errno));
+            return;
         }
 
-        Logger::log(std::cout, "swapped ", events.size(), " event(s) ...");
+        // the old callback might be the one running right now
+        m_retired.push_back(std::exchange(pos->second, std::make_unique<FdWatcher>(std::move(callback), events)));
+    }
+}
+
+void EventLoop::applyUnwatch(int fd)
+{
+    auto pos{ m_watchers.find(fd) };
+
+    if (pos == m_watchers.end()) {
+        return;
+    }
 
-        for (auto& callable : events)
+    ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);   // fails, if fd has been closed already
+
+    m_retired.push_back(std::move(pos->second));
+    m_watchers.erase(pos);
+}
+
+void EventLoop::poll(bool idle, std::uint32_t wakeups, std::optional<std::chrono::steady_clock::time_point> deadline)
+{
+    m_retired.clear();
+
+    // a busy loop checks the watched descriptors without blocking
+    if (!idle && m_watchers.empty()) {
+        return;
+    }
+
+    int timeout{ 0 };
+
+    if (idle)
+    {
+        if (deadline.has_value() && deadline.value() != m_armed) {
+            armTimer(deadline.value());
+        }
+
+        // publish the state first, then re-check inbox and timers: a producer pushing in the meantime
+        // sees m_parked (both are sequentially consistent, see MpscQueue::push)
+        m_parked.store(Waiting);
+
+        if (m_inbox.empty() && m_wakeups.load() == wakeups) {
+            timeout = -1;
+        }
+    }
+
+    std::array<::epoll_event, 64> events{};
+
+    int count{ ::epoll_wait(m_epoll, events.data(), static_cast<int>(events.size()), timeout) };
+
+    m_parked.store(Running);
+
+    for (int i{}; i < count; ++i)
+    {
+        int fd{ events[i].data.fd };
+
+        if (fd == m_wakeupFd || fd == m_timerFd)
         {
-            Logger::log(std::cout, "! invoking next event");
-            callable();
+            std::uint64_t value{};
+            [[maybe_unused]] auto result{ ::read(fd, &value, sizeof(value)) };
+
+            if (fd == m_timerFd) {
+                m_armed = {};
+            }
+
+            continue;
+        }
+
+        // the watcher might have been removed by a previous callback
+        auto pos{ m_watchers.find(fd) };
+
+        if (pos == m_watchers.end()) {
+            continue;
+        }
+
+        std::uint32_t ready{
+            ((events[i].events & EPOLLIN) ? Readable : 0u) |
+            ((events[i].events & EPOLLOUT) ? Writable : 0u) |
+            ((events[i].events & (EPOLLERR | EPOLLHUP)) ? Error : 0u)
+        };
+
+        pos->second->m_callback(ready);
+    }
+
+    m_retired.clear();
+}
+
+void EventLoop::armTimer(std::chrono::steady_clock::time_point deadline)
+{
+    auto nanoseconds{ std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count() };
+
+    // an expiry of zero would disarm the timer
+    nanoseconds = std::max<decltype(nanoseconds)>(nanoseconds, 1);
+
+    ::itimerspec spec{};
+    spec.it_value.tv_sec = static_cast<time_t>(nanoseconds / 1'000'000'000);
+    spec.it_value.tv_nsec = static_cast<long>(nanoseconds % 1'000'000'000);
+
+    ::timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+    m_armed = deadline;
+}
+
+#else
+
+bool EventLoop::watchFd(int, std::uint32_t, FdCallback)
+{
+    Logger::log(std::cout, "watchFd: not supported on this platform");
+    return false;
+}
+
+bool EventLoop::unwatchFd(int)
+{
+    return false;
+}
+
+void EventLoop::poll(bool idle, std::uint32_t wakeups, std::optional<std::chrono::steady_clock::time_point> deadline)
+{
+    if (!idle) {
+        return;
+    }
+
+    if (!deadline.has_value())
+    {
+        // publish the state first, then re-check the inbox: a producer pushing in the meantime
+        // sees m_parked (both are sequentially consistent, see MpscQueue::push)
+        m_parked.store(Waiting);
+
+        if (m_inbox.empty()) {
+            m_wakeups.wait(wakeups);
         }
+    }
+    else
+    {
+        std::unique_lock<std::mutex> guard{ m_mutex };
 
-        events.clear();  // empty container for next loop
+        m_parked.store(WaitingTimed);
+
+        if (m_inbox.empty()) {
+            m_condition.wait_until(guard, deadline.value(), [&] () { return m_wakeups.load() != wakeups; });
+        }
     }
+
+    m_parked.store(Running);
 }
 
+#endif
+
 // ===========================================================================
 // End-of-File
 // ===========================================================================
@@ -6,25 +6,80 @@
 
 #include "../Logger/Logger.h"
 
+#include "../Globals/TimerWheel.h"
+
+#include "MpscQueue.h"
+
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
+#if defined(__linux__)
+#define EVENTLOOP_EPOLL
+#endif
+
+// Events are posted into a lock-free inbox (MpscQueue): enqueue is a single atomic exchange,
+// the loop thread drains the whole chain in one pass. Producers wake up the loop only when it is parked.
+// Linux: the loop is a reactor - it sleeps in epoll_wait, woken up by an eventfd (posted events),
+// a timerfd (armed with the next timer expiry) or the readiness of a watched file descriptor.
+// Other platforms: an idle loop parks on an atomic counter, while timers are pending
+// it sleeps on a condition variable (std::atomic::wait has no timeout). watchFd isn't supported.
+
 class EventLoop
 {
 private:
     using Event = std::move_only_function<void()>;
 
+public:
+    using FdCallback = std::move_only_function<void(std::uint32_t events)>;
+
+    // readiness of a watched file descriptor
+    static constexpr std::uint32_t Readable{ 0x1 };
+    static constexpr std::uint32_t Writable{ 0x2 };
+    static constexpr std::uint32_t Error{ 0x4 };        // error or hang up, always reported
+
 private:
-    std::vector<Event>       m_events;
-    std::mutex               m_mutex;
-    std::condition_variable  m_condition;
-    std::jthread             m_thread;
-    bool                     m_running;
+    // values of m_parked
+    static constexpr std::uint32_t Running{ 0 };
+    static constexpr std::uint32_t Waiting{ 1 };        // epoll_wait - or std::atomic::wait on m_wakeups
+    static constexpr std::uint32_t WaitingTimed{ 2 };   // m_condition, until the next timer expires
+
+    MpscQueue<Event>            m_inbox;
+    std::atomic<std::uint32_t>  m_wakeups;    // changed by addTimer: the loop recalculates its waiting time
+    std::atomic<std::uint32_t>  m_parked;
+    TimerWheel<Event>           m_timers;     // delayed and periodic events, protected by m_mutex
+    std::mutex                  m_mutex;
+    std::jthread                m_thread;
+    bool                        m_running;    // accessed by the loop thread only (after start)
+
+#if defined(EVENTLOOP_EPOLL)
+    struct FdWatcher
+    {
+        FdCallback     m_callback;
+        std::uint32_t  m_events;
+    };
+
+    int                                     m_epoll;
+    int                                     m_wakeupFd;   // eventfd: posted events
+    int                                     m_timerFd;    // timerfd: next timer expiry
+    std::chrono::steady_clock::time_point   m_armed;      // current expiry of m_timerFd, loop thread only
+    // a callback may unwatch (or replace) itself: the watcher lives on the heap and is
+    // retired until the dispatch loop is done, so the running callback is never destroyed
+    std::unordered_map<int, std::unique_ptr<FdWatcher>>  m_watchers;   // loop thread only
+    std::vector<std::unique_ptr<FdWatcher>>              m_retired;    // replaced or removed while being dispatched
+#else
+    std::condition_variable                 m_condition;  // waiting for the next timer
+#endif
 
 public:
     // c'tor(s) / d'tor
@@ -46,7 +101,7 @@ public:
     template<typename TFunc, typename ... TArgs>
     void enqueueTask(TFunc&& func, TArgs&& ...args)
     {
-        Logger::log(std::cout, "enqueueTask ...");
+        Logger::trace(std::cout, "enqueueTask ...");
 
         // using "Generalized Lambda Capture" to preserve move semantics
         auto callable {
@@ -59,21 +114,17 @@ public:
             } 
         };
 
-        {
-            // RAII guard
-            std::lock_guard<std::mutex> guard{ m_mutex };
-            m_events.push_back(std::move(callable));
-        }
+        m_inbox.push(std::move(callable));
 
-        m_condition.notify_one();
+        wakeUp();
     }
 
-    // same method, avoiding code duplication of the mutex locking and notification logic,
+    // same method, avoiding code duplication of the inbox and notification logic,
     // leaving enqueue() as the single place responsible for inserting events into the queue.
     template<typename TFunc, typename ... TArgs>
     void enqueueTaskEx(TFunc&& func, TArgs&& ...args)
     {
-        Logger::log(std::cout, "enqueueTaskEx ...");
+        Logger::trace(std::cout, "enqueueTaskEx ...");
 
         auto callable{
             [func = std::forward<TFunc>(func),
@@ -86,11 +137,41 @@ public:
         enqueue(std::move(callable));
     }
 
+    // the event is enqueued after 'delay' - or every 'period', first time after one period
+    template<typename TFunc>
+    TimerHandle scheduleAfter(std::chrono::steady_clock::duration delay, TFunc&& func)
+    {
+        return addTimer(delay, std::chrono::steady_clock::duration::zero(), Event{ std::forward<TFunc>(func) });
+    }
+
+    template<typename TFunc>
+    TimerHandle scheduleEvery(std::chrono::steady_clock::duration period, TFunc&& func)
+    {
+        return addTimer(period, period, Event{ std::forward<TFunc>(func) });
+    }
+
+    // the callback is invoked on the loop thread whenever fd is ready (level-triggered):
+    // it has to read (write) the data - or unwatch fd. Watching an fd again replaces its callback.
+    // Called from another thread, the (un)registration is posted to the loop.
+    // Returns false, if not supported on this platform.
+    bool watchFd(int fd, std::uint32_t events, FdCallback callback);
+    bool unwatchFd(int fd);
+
     void start();
     void stop();
 
 private:
     void threadProcedure();
+    void poll(bool idle, std::uint32_t wakeups, std::optional<std::chrono::steady_clock::time_point> deadline);
+    void wakeUp();
+#if defined(EVENTLOOP_EPOLL)
+    void applyWatch(int fd, std::uint32_t events, FdCallback callback);
+    void applyUnwatch(int fd);
+    void armTimer(std::chrono::steady_clock::time_point deadline);
+    void closeDescriptors();
+#endif
+    TimerHandle addTimer(std::chrono::steady_clock::duration delay, std::chrono::steady_clock::duration period, Event callable);
+    bool cancelTimer(TimerId id);
 };
 
 // ===========================================================================
@@ -0,0 +1,109 @@
+// ===========================================================================
+// EventLoopGroup.cpp
+// ===========================================================================
+
+#include "EventLoopGroup.h"
+
+#include "../Globals/ThreadPlacement.h"
+
+#include <algorithm>
+#include <span>
+#include <string>
+#include <thread>
+
+// state of random loop selection
+static thread_local std::uint64_t t_random{ 0x9E3779B97F4A7C15ull ^ std::hash<std::thread::id>{}(std::this_thread::get_id()) };
+
+EventLoopGroup::EventLoopGroup(std::size_t count, bool pinned)
+    : m_next{}, m_pinned{ pinned }
+{
+    if (count == 0) {
+        count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    m_slots.reserve(count);
+
+    for (std::size_t i{}; i != count; ++i) {
+        m_slots.push_back(std::make_unique<Slot>());
+    }
+}
+
+EventLoopGroup::~EventLoopGroup()
+{
+    stop();
+}
+
+void EventLoopGroup::start()
+{
+    std::size_t cores{ std::max(std::thread::hardware_concurrency(), 1u) };
+
+    for (std::size_t i{}; i != m_slots.size(); ++i)
+    {
+        EventLoop& loop{ m_slots[i]->m_loop };
+
+        loop.start();
+
+        // the very first event: placement of the loop thread
+        loop.enqueue([i, cores, pinned = m_pinned] () {
+            if (pinned) {
+                std::size_t cpu{ i % cores };
+
+                if (!ThreadPlacement::setAffinity(std::span<const std::size_t>{ &cpu, 1 })) {
+                    Logger::log(std::cout, "Event loop ", i, ": couldn't set CPU affinity");
+                }
+            }
+
+            std::string name{ "event-loop-" + std::to_string(i) };
+
+            ThreadPlacement::setName(name);
+            Logger::setThreadName(name);
+        });
+    }
+}
+
+void EventLoopGroup::stop()
+{
+    for (auto& slot : m_slots) {
+        slot->m_loop.stop();
+    }
+}
+
+std::size_t EventLoopGroup::leastLoaded()
+{
+    std::size_t count{ m_slots.size() };
+
+    if (count == 1) {
+        return 0;
+    }
+
+    // xorshift: two different random loops
+    t_random ^= t_random << 13;
+    t_random ^= t_random >> 7;
+    t_random ^= t_random << 17;
+
+    std::size_t first{ static_cast<std::size_t>(t_random % count) };
+    std::size_t second{ (first + 1 + static_cast<std::size_t>((t_random >> 32) % (count - 1))) % count };
+
+    return m_slots[first]->m_pending.load(std::memory_order_relaxed) <= m_slots[second]->m_pending.load(std::memory_order_relaxed)
+        ? first
+        : second;
+}
+
+std::size_t EventLoopGroup::size() const
+{
+    return m_slots.size();
+}
+
+EventLoop& EventLoopGroup::loop(std::size_t index)
+{
+    return m_slots[index]->m_loop;
+}
+
+std::size_t EventLoopGroup::pending(std::size_t index) const
+{
+    return m_slots[index]->m_pending.load(std::memory_order_relaxed);
+}
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -0,0 +1,115 @@
+// ===========================================================================
+// EventLoopGroup.h
+// ===========================================================================
+
+#pragma once
+
+#include "EventLoop.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// A fixed set of event loops, each running on its own thread (optionally pinned to a core).
+// post(key, func): the same key is always dispatched to the same loop - all events of a key
+// are executed sequentially on a single thread, state per key needs no locking.
+// Keyless events are distributed round-robin or to the least loaded loop
+// (number of posted, not yet executed events - "power of two choices":
+// two randomly chosen loops are compared, not all of them).
+
+class EventLoopGroup
+{
+private:
+    struct alignas(std::hardware_destructive_interference_size) Slot
+    {
+        EventLoop                 m_loop;
+        std::atomic<std::size_t>  m_pending{};   // posted via the group, not yet executed
+    };
+
+    std::vector<std::unique_ptr<Slot>>   m_slots;
+    std::atomic<std::size_t>             m_next;      // round-robin
+    bool                                 m_pinned;
+
+public:
+    // c'tor(s) / d'tor
+    explicit EventLoopGroup(std::size_t count = 0, bool pinned = true);   // 0: std::thread::hardware_concurrency()
+    ~EventLoopGroup();
+
+    // no copying or moving
+    EventLoopGroup(const EventLoopGroup&) = delete;
+    EventLoopGroup& operator= (const EventLoopGroup&) = delete;
+    EventLoopGroup(EventLoopGroup&&) = delete;
+    EventLoopGroup& operator= (EventLoopGroup&&) = delete;
+
+    // public interface
+    void start();
+    void stop();
+
+    // key-affine: same key, same loop
+    template<typename TKey, typename TFunc>
+    void post(const TKey& key, TFunc&& func)
+    {
+        dispatch(indexOf(key), std::forward<TFunc>(func));
+    }
+
+    // round-robin
+    template<typename TFunc>
+    void post(TFunc&& func)
+    {
+        dispatch(m_next.fetch_add(1, std::memory_order_relaxed) % m_slots.size(), std::forward<TFunc>(func));
+    }
+
+    template<typename TFunc>
+    void postLeastLoaded(TFunc&& func)
+    {
+        dispatch(leastLoaded(), std::forward<TFunc>(func));
+    }
+
+    // loop of a key - e.g. for timers or watched file descriptors belonging to the key
+    template<typename TKey>
+    EventLoop& loopFor(const TKey& key)
+    {
+        return m_slots[indexOf(key)]->m_loop;
+    }
+
+    // getter
+    std::size_t size() const;
+    EventLoop& loop(std::size_t index);
+    std::size_t pending(std::size_t index) const;
+
+private:
+    template<typename TKey>
+    std::size_t indexOf(const TKey& key) const
+    {
+        // Fibonacci hashing: std::hash is the identity for integral types on most platforms
+        std::uint64_t hash{ static_cast<std::uint64_t>(std::hash<TKey>{}(key)) * 0x9E3779B97F4A7C15ull };
+
+        return static_cast<std::size_t>((hash >> 32) % m_slots.size());
+    }
+
+    template<typename TFunc>
+    void dispatch(std::size_t index, TFunc&& func)
+    {
+        Slot* slot{ m_slots[index].get() };
+
+        slot->m_pending.fetch_add(1, std::memory_order_relaxed);
+
+        slot->m_loop.enqueue(
+            [slot, func = std::forward<TFunc>(func)] () mutable {
+                func();
+                slot->m_pending.fetch_sub(1, std::memory_order_relaxed);
+            }
+        );
+    }
+
+    std::size_t leastLoaded();
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
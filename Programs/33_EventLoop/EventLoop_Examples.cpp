@@ -8,10 +8,29 @@
 #include "../Globals/GlobalPrimes.h"
 #include "../Globals/IsPrime.h"
 
-#include "EventLoop.h"
+#include "../22_ProducerConsumerProblem/BlockingQueue.h"
 
+#include "EventLoop.h"
+#include "EventLoopGroup.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <print>
+#include <thread>
+#include <vector>
+
+#if defined(EVENTLOOP_EPOLL)
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 // ===========================================================================
 // demonstration of std::move_only_function
@@ -307,6 +326,742 @@ void test_event_loop_20()
     Logger::log(std::cout, "Done.");
 }
 
+// ===========================================================================
+// delayed and periodic events (timer wheel driven by the event loop thread)
+
+void test_event_loop_21()
+{
+    Logger::log(std::cout, "Start");
+
+    EventLoop eventLoop{};
+
+    eventLoop.start();
+
+    auto start{ std::chrono::steady_clock::now() };
+
+    auto elapsed = [start] () {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    eventLoop.scheduleAfter(std::chrono::milliseconds{ 50 }, [&] () {
+        Logger::log(std::cout, "after 50 ms: ", elapsed(), " [milliseconds]");
+    });
+
+    TimerHandle ticker{ eventLoop.scheduleEvery(std::chrono::milliseconds{ 100 }, [&] () {
+        Logger::log(std::cout, "every 100 ms: ", elapsed(), " [milliseconds]");
+    }) };
+
+    TimerHandle never{ eventLoop.scheduleAfter(std::chrono::milliseconds{ 200 }, [] () {
+        Logger::log(std::cout, "cancelled timer fired - unexpected!");
+    }) };
+
+    never.cancel();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 550 });
+
+    ticker.cancel();
+
+    eventLoop.stop();
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// benchmark: enqueue throughput of the lock-free inbox (MpscQueue)
+// compared with the former inbox (std::mutex, swapping std::vector buffers)
+
+class MutexSwapEventLoop
+{
+private:
+    using Event = std::move_only_function<void()>;
+
+    std::vector<Event>       m_events;
+    std::mutex               m_mutex;
+    std::condition_variable  m_condition;
+    std::jthread             m_thread;
+    bool                     m_running{ false };
+
+public:
+    ~MutexSwapEventLoop() { stop(); }
+
+    void start()
+    {
+        m_running = true;
+        m_thread = std::jthread{ [this] () { threadProcedure(); } };
+    }
+
+    void stop()
+    {
+        if (m_thread.joinable()) {
+            enqueue([this] { m_running = false; });
+            m_thread.join();
+        }
+    }
+
+    void enqueue(Event callable)
+    {
+        {
+            std::lock_guard<std::mutex> guard{ m_mutex };
+            m_events.push_back(std::move(callable));
+        }
+
+        m_condition.notify_one();
+    }
+
+private:
+    void threadProcedure()
+    {
+        std::vector<Event> events;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> guard{ m_mutex };
+
+                m_condition.wait(guard, [this] () -> bool { return !m_events.empty() || !m_running; });
+
+                if (!m_running && m_events.empty()) {
+                    return;
+                }
+
+                std::swap(events, m_events);
+            }
+
+            for (auto& callable : events) {
+                callable();
+            }
+
+            events.clear();
+        }
+    }
+};
+
+template <typename TEventLoop>
+static void benchmarkEnqueue(const char* name, std::size_t numProducers)
+{
+    constexpr std::size_t NumEvents{ 1'000'000 };
+
+    std::size_t perProducer{ NumEvents / numProducers };
+    std::size_t invoked{};   // incremented by the loop thread only
+
+    Logger::enableLogging(false);
+
+    TEventLoop eventLoop{};
+
+    eventLoop.start();
+
+    std::atomic<bool> go{ false };
+    std::vector<std::jthread> producers;
+
+    for (std::size_t i{}; i != numProducers; ++i)
+    {
+        producers.emplace_back([&] () {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+
+            for (std::size_t n{}; n != perProducer; ++n) {
+                eventLoop.enqueue([&invoked] () { ++invoked; });
+            }
+        });
+    }
+
+    auto begin{ std::chrono::steady_clock::now() };
+
+    go = true;
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    auto enqueued{ std::chrono::steady_clock::now() };
+
+    eventLoop.stop();
+
+    auto end{ std::chrono::steady_clock::now() };
+
+    auto enqueueTime{ std::chrono::duration_cast<std::chrono::microseconds>(enqueued - begin).count() };
+    auto totalTime{ std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() };
+
+    Logger::enableLogging(true);
+
+    Logger::log(std::cout, name, numProducers, " producers: ",
+        (perProducer * numProducers * 1'000) / std::max<long long>(enqueueTime, 1), " events/ms enqueued, ",
+        (invoked * 1'000) / std::max<long long>(totalTime, 1), " events/ms invoked");
+}
+
+void test_event_loop_22()
+{
+    Logger::log(std::cout, "Start");
+
+    for (std::size_t numProducers : { 1, 2, 4, 8, 16, 32 })
+    {
+        benchmarkEnqueue<MutexSwapEventLoop>("std::mutex + swap: ", numProducers);
+        benchmarkEnqueue<EventLoop>("MpscQueue:         ", numProducers);
+    }
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// reactor: socket readiness, timers and posted events - all on the loop thread
+// (ping-pong between the two ends of a socketpair)
+
+void test_event_loop_23()
+{
+    Logger::log(std::cout, "Start");
+
+#if defined(EVENTLOOP_EPOLL)
+
+    constexpr std::size_t NumRoundTrips{ 100'000 };
+
+    int sockets[2]{};
+
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+        Logger::log(std::cout, "socketpair failed");
+        return;
+    }
+
+    EventLoop eventLoop{};
+
+    eventLoop.start();
+
+    Logger::enableLogging(false);
+
+    // state of the loop thread: no synchronization needed
+    std::size_t roundTrips{};
+    std::size_t ticks{};
+    std::size_t posted{};
+
+    std::promise<void> done{};
+
+    // first end: counts the round trips and sends the next ping
+    eventLoop.watchFd(sockets[0], EventLoop::Readable, [&] (std::uint32_t) {
+        std::size_t value{};
+        if (::read(sockets[0], &value, sizeof(value)) != sizeof(value)) {
+            return;
+        }
+
+        if (++roundTrips == NumRoundTrips) {
+            done.set_value();
+            return;
+        }
+
+        [[maybe_unused]] auto result{ ::write(sockets[0], &roundTrips, sizeof(roundTrips)) };
+    });
+
+    // second end: echo
+    eventLoop.watchFd(sockets[1], EventLoop::Readable, [&] (std::uint32_t) {
+        std::size_t value{};
+        if (::read(sockets[1], &value, sizeof(value)) == sizeof(value)) {
+            [[maybe_unused]] auto result{ ::write(sockets[1], &value, sizeof(value)) };
+        }
+    });
+
+    TimerHandle ticker{ eventLoop.scheduleEvery(std::chrono::milliseconds{ 10 }, [&] () { ++ticks; }) };
+
+    auto begin{ std::chrono::steady_clock::now() };
+
+    // first ping
+    eventLoop.enqueue([&] () {
+        [[maybe_unused]] auto result{ ::write(sockets[0], &roundTrips, sizeof(roundTrips)) };
+    });
+
+    // events posted from another thread in the meantime
+    std::jthread producer{ [&] () {
+        for (std::size_t n{}; n != 1'000; ++n) {
+            eventLoop.enqueue([&] () { ++posted; });
+            std::this_thread::sleep_for(std::chrono::microseconds{ 100 });
+        }
+    } };
+
+    done.get_future().wait();
+
+    auto end{ std::chrono::steady_clock::now() };
+
+    producer.join();
+    ticker.cancel();
+
+    eventLoop.unwatchFd(sockets[0]);
+    eventLoop.unwatchFd(sockets[1]);
+
+    eventLoop.stop();
+
+    ::close(sockets[0]);
+    ::close(sockets[1]);
+
+    Logger::enableLogging(true);
+
+    auto microseconds{ std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() };
+
+    Logger::log(std::cout, NumRoundTrips, " round trips in ", microseconds / 1'000, " ms: ",
+        (NumRoundTrips * 1'000) / std::max<long long>(microseconds, 1), " round trips/ms");
+    Logger::log(std::cout, "Timer ticks: ", ticks, ", posted events: ", posted);
+
+#else
+
+    Logger::log(std::cout, "watchFd requires epoll (Linux)");
+
+#endif
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// EventLoopGroup: key-affine dispatch, scaling from 1 to N loops
+
+static void benchmarkGroup(std::size_t numLoops)
+{
+    constexpr std::size_t NumEvents{ 400'000 };
+    constexpr std::size_t NumKeys{ 1'024 };
+    constexpr std::size_t NumProducers{ 4 };
+    constexpr std::size_t Work{ 200 };        // xorshift rounds per event (about 1 microsecond)
+
+    // per-key state: touched only by the loop owning the key - no locking, no atomics
+    std::vector<std::size_t> counters(NumKeys);
+    std::vector<std::uint64_t> states(NumKeys, 1);
+
+    Logger::enableLogging(false);
+
+    EventLoopGroup group{ numLoops };
+
+    group.start();
+
+    std::atomic<bool> go{ false };
+    std::vector<std::jthread> producers;
+
+    for (std::size_t i{}; i != NumProducers; ++i)
+    {
+        producers.emplace_back([&, i] () {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+
+            for (std::size_t n{ i }; n < NumEvents; n += NumProducers)
+            {
+                std::size_t key{ n % NumKeys };
+
+                group.post(key, [&counters, &states, key] () {
+                    std::uint64_t x{ states[key] };
+                    for (std::size_t round{}; round != Work; ++round) {
+                        x ^= x << 13;
+                        x ^= x >> 7;
+                        x ^= x << 17;
+                    }
+                    states[key] = x;
+                    ++counters[key];
+                });
+            }
+        });
+    }
+
+    auto begin{ std::chrono::steady_clock::now() };
+
+    go = true;
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    group.stop();
+
+    auto end{ std::chrono::steady_clock::now() };
+
+    Logger::enableLogging(true);
+
+    std::size_t total{};
+    for (std::size_t count : counters) {
+        total += count;
+    }
+
+    auto totalTime{ std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() };
+
+    Logger::log(std::cout, numLoops, " loop(s): ", (total * 1'000) / std::max<long long>(totalTime, 1),
+        " events/ms", (total == NumEvents) ? "" : " - events lost!");
+}
+
+void test_event_loop_24()
+{
+    Logger::log(std::cout, "Start");
+
+    std::size_t cores{ std::max(std::thread::hardware_concurrency(), 1u) };
+
+    for (std::size_t numLoops{ 1 }; numLoops <= cores; numLoops *= 2) {
+        benchmarkGroup(numLoops);
+    }
+
+    // keyless work: round-robin and least-loaded, the pending counters drop back to zero
+    Logger::enableLogging(false);
+
+    EventLoopGroup group{ 4, false };
+
+    group.start();
+
+    std::atomic<std::size_t> invoked{};
+
+    for (std::size_t n{}; n != 10'000; ++n)
+    {
+        if (n % 2 == 0) {
+            group.post([&invoked] () { invoked.fetch_add(1, std::memory_order_relaxed); });
+        }
+        else {
+            group.postLeastLoaded([&invoked] () { invoked.fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+
+    group.stop();
+
+    Logger::enableLogging(true);
+
+    Logger::log(std::cout, "round-robin + least-loaded: ", invoked.load(), " events invoked, pending: ",
+        group.pending(0), " ", group.pending(1), " ", group.pending(2), " ", group.pending(3));
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// SpscQueue: one producer and one consumer - compared with the BlockingQueue (mutex + condition variables),
+// round trip latency between two threads and between two event loops
+
+constexpr std::size_t SpscMessages{ 4'000'000 };
+constexpr std::size_t SpscBatch{ 64 };
+constexpr std::size_t SpscRoundTrips{ 100'000 };
+
+template <typename TProduce, typename TConsume>
+static void benchmarkTransport(const char* name, TProduce produce, TConsume consume)
+{
+    Logger::enableLogging(false);
+
+    std::uint64_t sum{};
+
+    auto begin{ std::chrono::steady_clock::now() };
+    {
+        std::jthread producer{ produce };
+        std::jthread consumer{ [&] () { sum = consume(); } };
+    }   // joins
+    auto end{ std::chrono::steady_clock::now() };
+
+    Logger::enableLogging(true);
+
+    auto microseconds{ std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() };
+
+    Logger::log(std::cout, name, (SpscMessages * 1'000'000) / std::max<long long>(microseconds, 1), " msgs/s",
+        (sum == SpscMessages * (SpscMessages - 1) / 2) ? "" : " - messages lost!");
+}
+
+// the producing event loop pushes into the ring and posts a drain event to the consuming loop -
+// only if there isn't one pending already
+template <typename T, std::size_t Capacity>
+class SpscLink
+{
+private:
+    SpscQueue<T, Capacity>              m_queue;
+    std::atomic<bool>                   m_scheduled;
+    EventLoop&                          m_target;
+    std::move_only_function<void(T&)>  m_handler;    // invoked on the target loop
+
+public:
+    SpscLink(EventLoop& target, std::move_only_function<void(T&)> handler)
+        : m_scheduled{ false }, m_target{ target }, m_handler{ std::move(handler) }
+    {}
+
+    // producing loop only
+    bool send(T value)
+    {
+        if (!m_queue.push(std::move(value))) {
+            return false;
+        }
+
+        // acq_rel: either the pending drain event sees the value, or the value posts a new one
+        if (!m_scheduled.exchange(true, std::memory_order_acq_rel)) {
+            m_target.enqueue([this] () { drain(); });
+        }
+
+        return true;
+    }
+
+private:
+    void drain()
+    {
+        m_scheduled.exchange(false, std::memory_order_acq_rel);
+
+        T values[SpscBatch]{};
+        std::size_t count{};
+
+        while ((count = m_queue.pop_n(values, SpscBatch)) != 0) {
+            for (std::size_t i{}; i != count; ++i) {
+                m_handler(values[i]);
+            }
+        }
+    }
+};
+
+static std::int64_t nanosecondsNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void test_event_loop_25()
+{
+    Logger::log(std::cout, "Start");
+
+    // throughput
+    {
+        ProducerConsumerQueue::BlockingQueue<std::uint64_t, 1024> queue{};
+
+        benchmarkTransport("BlockingQueue push / pop:    ",
+            [&] () {
+                for (std::uint64_t n{}; n != SpscMessages; ++n) {
+                    queue.push(n);
+                }
+            },
+            [&] () {
+                std::uint64_t sum{};
+                std::uint64_t value{};
+                for (std::size_t n{}; n != SpscMessages; ++n) {
+                    queue.pop(value);
+                    sum += value;
+                }
+                return sum;
+            }
+        );
+    }
+
+    {
+        SpscQueue<std::uint64_t, 1024> queue{};
+
+        benchmarkTransport("SpscQueue push / pop:        ",
+            [&] () {
+                for (std::uint64_t n{}; n != SpscMessages; ++n) {
+                    while (!queue.push(n)) {
+                        std::this_thread::yield();
+                    }
+                }
+            },
+            [&] () {
+                std::uint64_t sum{};
+                std::uint64_t value{};
+                for (std::size_t n{}; n != SpscMessages; ++n) {
+                    while (!queue.pop(value)) {
+                        std::this_thread::yield();
+                    }
+                    sum += value;
+                }
+                return sum;
+            }
+        );
+    }
+
+    {
+        SpscQueue<std::uint64_t, 1024> queue{};
+
+        benchmarkTransport("SpscQueue push_n / pop_n:    ",
+            [&] () {
+                std::uint64_t batch[SpscBatch]{};
+                for (std::uint64_t n{}; n != SpscMessages; ) {
+                    std::size_t count{ std::min<std::size_t>(SpscBatch, SpscMessages - n) };
+                    for (std::size_t i{}; i != count; ++i) {
+                        batch[i] = n + i;
+                    }
+
+                    for (std::size_t pushed{}; pushed != count; ) {
+                        std::size_t result{ queue.push_n(batch + pushed, count - pushed) };
+                        if (result == 0) {
+                            std::this_thread::yield();
+                        }
+                        pushed += result;
+                    }
+
+                    n += count;
+                }
+            },
+            [&] () {
+                std::uint64_t sum{};
+                std::uint64_t batch[SpscBatch]{};
+                for (std::size_t received{}; received != SpscMessages; ) {
+                    std::size_t count{ queue.pop_n(batch, SpscBatch) };
+                    if (count == 0) {
+                        std::this_thread::yield();
+                    }
+                    for (std::size_t i{}; i != count; ++i) {
+                        sum += batch[i];
+                    }
+                    received += count;
+                }
+                return sum;
+            }
+        );
+    }
+
+    // round trip latency: two threads, polling
+    {
+        LatencyHistogram& histogram{ LatencyHistogram::get("SpscQueue round trip, threads") };
+
+        SpscQueue<std::int64_t, 64> ping{};
+        SpscQueue<std::int64_t, 64> pong{};
+
+        std::jthread echo{ [&] () {
+            std::int64_t value{};
+            for (std::size_t n{}; n != SpscRoundTrips; ++n) {
+                while (!ping.pop(value)) {
+                    std::this_thread::yield();
+                }
+                pong.push(value);
+            }
+        } };
+
+        std::int64_t value{};
+        for (std::size_t n{}; n != SpscRoundTrips; ++n) {
+            ping.push(nanosecondsNow());
+            while (!pong.pop(value)) {
+                std::this_thread::yield();
+            }
+            histogram.record(std::chrono::nanoseconds{ nanosecondsNow() - value });
+        }
+
+        Logger::log(std::cout, histogram.toString());
+    }
+
+    // round trip latency: two event loops, each link drained by the receiving loop
+    {
+        LatencyHistogram& histogram{ LatencyHistogram::get("SpscQueue round trip, event loops") };
+
+        EventLoop first{};
+        EventLoop second{};
+
+        std::promise<void> done{};
+        std::size_t roundTrips{};    // first loop only
+
+        std::unique_ptr<SpscLink<std::int64_t, 64>> toFirst{};
+
+        SpscLink<std::int64_t, 64> toSecond{ second, [&] (std::int64_t& value) { toFirst->send(value); } };
+
+        toFirst = std::make_unique<SpscLink<std::int64_t, 64>>(first, [&] (std::int64_t& value) {
+            histogram.record(std::chrono::nanoseconds{ nanosecondsNow() - value });
+
+            if (++roundTrips == SpscRoundTrips) {
+                done.set_value();
+                return;
+            }
+
+            toSecond.send(nanosecondsNow());
+        });
+
+        Logger::enableLogging(false);
+
+        first.start();
+        second.start();
+
+        first.enqueue([&] () { toSecond.send(nanosecondsNow()); });
+
+        done.get_future().wait();
+
+        first.stop();
+        second.stop();
+
+        Logger::enableLogging(true);
+
+        Logger::log(std::cout, histogram.toString());
+    }
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// reactor: a callback replacing and finally unwatching its own file descriptor
+// (the running callback must survive both)
+
+void test_event_loop_26()
+{
+    Logger::log(std::cout, "Start");
+
+#if defined(EVENTLOOP_EPOLL)
+
+    constexpr std::size_t NumMessages{ 3 };
+
+    // state of the loop thread: the callbacks capture a single pointer,
+    // small enough to be stored inside the std::move_only_function itself
+    struct Reader
+    {
+        EventLoop&          m_eventLoop;
+        int                 m_fd;
+        std::size_t         m_received;
+        std::promise<void>  m_done;
+
+        std::size_t read()
+        {
+            std::size_t value{};
+            return (::read(m_fd, &value, sizeof(value)) == sizeof(value)) ? value : 0;
+        }
+    };
+
+    int sockets[2]{};
+
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+        Logger::log(std::cout, "socketpair failed");
+        return;
+    }
+
+    EventLoop eventLoop{};
+
+    eventLoop.start();
+
+    Reader reader{ eventLoop, sockets[1], 0, {} };
+
+    // second callback: unwatches its own fd, then still uses its capture
+    auto lastCallback{ [state = &reader] (std::uint32_t) {
+        std::size_t value{ state->read() };
+        if (value == 0) {
+            return;
+        }
+
+        state->m_eventLoop.unwatchFd(state->m_fd);
+
+        ++state->m_received;
+        Logger::log(std::cout, "Unwatched fd ", state->m_fd, " after message ", value);
+        state->m_done.set_value();
+    } };
+
+    // first callback: replaces itself after the first messages
+    eventLoop.watchFd(sockets[1], EventLoop::Readable, [state = &reader, &lastCallback] (std::uint32_t) {
+        std::size_t value{ state->read() };
+        if (value == 0) {
+            return;
+        }
+
+        if (++state->m_received == NumMessages - 1) {
+            state->m_eventLoop.watchFd(state->m_fd, EventLoop::Readable, std::move(lastCallback));
+            Logger::log(std::cout, "Replaced callback of fd ", state->m_fd, " after message ", value);
+        }
+    });
+
+    // one message after the other: each one is read by a single callback invocation
+    for (std::size_t n{ 1 }; n <= NumMessages; ++n) {
+        eventLoop.enqueue([fd = sockets[0], n] () {
+            [[maybe_unused]] auto result{ ::write(fd, &n, sizeof(n)) };
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+    }
+
+    reader.m_done.get_future().wait();
+
+    eventLoop.stop();
+
+    ::close(sockets[0]);
+    ::close(sockets[1]);
+
+    Logger::log(std::cout, "Received ", reader.m_received, " of ", NumMessages, " messages");
+
+#else
+
+    Logger::log(std::cout, "watchFd requires epoll (Linux)");
+
+#endif
+
+    Logger::log(std::cout, "Done.");
+}
+
 // ===========================================================================
 // End-of-File
 // ===========================================================================
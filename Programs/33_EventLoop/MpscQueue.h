@@ -0,0 +1,119 @@
+// ===========================================================================
+// MpscQueue.h // Lock-free multiple producer / single consumer queue
+// ===========================================================================
+
+#pragma once
+
+#include "../Globals/MemoryPool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Node based queue of Dmitry Vyukov: the value is stored in the node itself, the nodes are linked
+// through their m_next pointers. A producer links in a node with a single atomic exchange
+// (no CAS loop, no lock), the consumer walks along the chain without any atomic read-modify-write.
+// The first node of the chain is a dummy, its value has already been consumed.
+// Between the exchange and the store of m_next the chain is briefly "broken":
+// the consumer sees the queue as not empty, but cannot take the next value yet.
+// Nodes are recycled by a BlockPool (allocated by the producers, released by the consumer).
+
+template <typename T>
+class MpscQueue
+{
+private:
+    struct Node
+    {
+        std::atomic<Node*>  m_next{ nullptr };
+        T                   m_value{};
+
+        Node() = default;
+
+        explicit Node(T&& value) : m_next{ nullptr }, m_value{ std::move(value) } {}
+
+        static void* operator new(std::size_t)
+        {
+            return BlockPool<sizeof(Node)>::allocate();
+        }
+
+        static void operator delete(void* ptr)
+        {
+            BlockPool<sizeof(Node)>::deallocate(ptr);
+        }
+    };
+
+    alignas(std::hardware_destructive_interference_size) std::atomic<Node*> m_head;   // last node, producers
+    alignas(std::hardware_destructive_interference_size) Node*              m_tail;   // dummy node, consumer
+
+public:
+    // c'tor/d'tor
+    MpscQueue() : m_head{ nullptr }, m_tail{ new Node{} }
+    {
+        m_head.store(m_tail, std::memory_order_relaxed);
+    }
+
+    ~MpscQueue()
+    {
+        while (m_tail != nullptr) {
+            delete std::exchange(m_tail, m_tail->m_next.load(std::memory_order_relaxed));
+        }
+    }
+
+    // no copying or moving
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    MpscQueue(MpscQueue&&) = delete;
+    MpscQueue& operator=(MpscQueue&&) = delete;
+
+    // producers: any thread
+    void push(T value)
+    {
+        Node* node{ new Node{ std::move(value) } };
+
+        // sequentially consistent: a consumer going to sleep either sees this node,
+        // or the producer sees the consumer sleeping (see EventLoop::park)
+        Node* previous{ m_head.exchange(node, std::memory_order_seq_cst) };
+
+        previous->m_next.store(node, std::memory_order_release);
+    }
+
+    // consumer only: takes all values enqueued up to now and hands them over to 'func' - in FIFO order.
+    // Values enqueued by 'func' itself are left for the next call.
+    template <typename TFunc>
+    std::size_t drain(TFunc&& func)
+    {
+        Node* last{ m_head.load(std::memory_order_acquire) };
+
+        std::size_t count{};
+
+        while (m_tail != last)
+        {
+            Node* next{ m_tail->m_next.load(std::memory_order_acquire) };
+
+            if (next == nullptr) {
+                break;   // a producer is in the middle of a push
+            }
+
+            delete m_tail;
+            m_tail = next;
+
+            T value{ std::move(next->m_value) };   // 'next' is the new dummy
+            ++count;
+
+            func(value);
+        }
+
+        return count;
+    }
+
+    // consumer only
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_seq_cst) == m_tail;
+    }
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -11,6 +11,12 @@ extern void test_event_loop_10();  // demonstrating enqueuing events with parame
 extern void test_event_loop_11();  // demonstrating enqueuing events with several functions with different signatures
 extern void test_event_loop_15();  // using std::invoke or not?
 extern void test_event_loop_20();  // searching prime numbers: first enqueuing events, than starting calculations
+extern void test_event_loop_21();  // delayed and periodic events, cancelling timers
+extern void test_event_loop_22();  // benchmark: lock-free inbox versus std::mutex + swap, 1 to 32 producers
+extern void test_event_loop_23();  // reactor: socket readiness, timers and posted events on the loop thread
+extern void test_event_loop_24();  // EventLoopGroup: key-affine dispatch, scaling from 1 to N loops
+extern void test_event_loop_25();  // SpscQueue: throughput versus BlockingQueue, round trip latency
+extern void test_event_loop_26();  // reactor: a callback replacing and unwatching its own file descriptor
 
 int main()
 {
@@ -23,6 +29,12 @@ int main()
     test_event_loop_11();          // demonstrating enqueuing events with several functions with different signatures
     test_event_loop_15();          // using std::invoke or not?
     test_event_loop_20();          // searching prime numbers: first enqueuing events, than starting calculations
+    test_event_loop_21();          // delayed and periodic events, cancelling timers
+    test_event_loop_22();          // benchmark: lock-free inbox versus std::mutex + swap, 1 to 32 producers
+    test_event_loop_23();          // reactor: socket readiness, timers and posted events on the loop thread
+    test_event_loop_24();          // EventLoopGroup: key-affine dispatch, scaling from 1 to N loops
+    test_event_loop_25();          // SpscQueue: throughput versus BlockingQueue, round trip latency
+    test_event_loop_26();          // reactor: a callback replacing and unwatching its own file descriptor
 
     return 0;
 }
@@ -0,0 +1,175 @@
+// ===========================================================================
+// SpscQueue.h // Wait-free single producer / single consumer ring buffer
+// ===========================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Bounded ring of Capacity slots (a power of two) for exactly one producer and one consumer thread.
+// The producer owns m_head, the consumer owns m_tail: each index is published with a release store
+// and read by the other side with an acquire load - no read-modify-write, no lock, no retry loop,
+// every operation finishes in a bounded number of steps (wait-free).
+// Both sides keep a private copy of the other index and reload it only when the ring looks
+// full (empty), so the two index cache lines are not passed back and forth on every operation.
+// push_n / pop_n move a whole batch with a single index update.
+// A full (empty) ring is reported, never waited for - waiting is up to the caller,
+// e.g. an EventLoop being notified, when the consumer isn't scheduled already.
+// Values popped are moved out of their slots, the moved-from objects stay until the slot is reused.
+
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two");
+
+private:
+    static constexpr std::size_t Mask{ Capacity - 1 };
+
+    struct alignas(std::hardware_destructive_interference_size) ProducerSide
+    {
+        std::atomic<std::size_t>  m_head{};         // next slot to write
+        std::size_t               m_cachedTail{};   // index of the consumer, as seen last time
+    };
+
+    struct alignas(std::hardware_destructive_interference_size) ConsumerSide
+    {
+        std::atomic<std::size_t>  m_tail{};         // next slot to read
+        std::size_t               m_cachedHead{};   // index of the producer, as seen last time
+    };
+
+    ProducerSide            m_producer;
+    ConsumerSide            m_consumer;
+    std::unique_ptr<T[]>    m_slots;
+
+public:
+    // c'tor
+    SpscQueue() : m_slots{ std::make_unique<T[]>(Capacity) } {}
+
+    // no copying or moving
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+    SpscQueue(SpscQueue&&) = delete;
+    SpscQueue& operator=(SpscQueue&&) = delete;
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    // producer only: false, if the ring is full ('value' is left untouched)
+    template <typename TValue>
+    bool push(TValue&& value)
+    {
+        std::size_t head{ m_producer.m_head.load(std::memory_order_relaxed) };
+
+        if (freeSlots(head) == 0) {
+            return false;
+        }
+
+        m_slots[head & Mask] = std::forward<TValue>(value);
+
+        m_producer.m_head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // producer only: moves as many of the 'count' values starting at 'first' as fit, returns their number
+    template <typename TInputIt>
+    std::size_t push_n(TInputIt first, std::size_t count)
+    {
+        std::size_t head{ m_producer.m_head.load(std::memory_order_relaxed) };
+        std::size_t pushed{ std::min(count, freeSlots(head, count)) };
+
+        for (std::size_t i{}; i != pushed; ++i, ++first) {
+            m_slots[(head + i) & Mask] = std::move(*first);
+        }
+
+        if (pushed != 0) {
+            m_producer.m_head.store(head + pushed, std::memory_order_release);
+        }
+
+        return pushed;
+    }
+
+    // consumer only: false, if the ring is empty
+    bool pop(T& value)
+    {
+        std::size_t tail{ m_consumer.m_tail.load(std::memory_order_relaxed) };
+
+        if (usedSlots(tail) == 0) {
+            return false;
+        }
+
+        value = std::move(m_slots[tail & Mask]);
+
+        m_consumer.m_tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // consumer only: moves up to 'max' values to 'out', returns their number
+    template <typename TOutputIt>
+    std::size_t pop_n(TOutputIt out, std::size_t max)
+    {
+        std::size_t tail{ m_consumer.m_tail.load(std::memory_order_relaxed) };
+        std::size_t popped{ std::min(max, usedSlots(tail, max)) };
+
+        for (std::size_t i{}; i != popped; ++i, ++out) {
+            *out = std::move(m_slots[(tail + i) & Mask]);
+        }
+
+        if (popped != 0) {
+            m_consumer.m_tail.store(tail + popped, std::memory_order_release);
+        }
+
+        return popped;
+    }
+
+    // approximate while the other side is active
+    std::size_t size() const
+    {
+        std::size_t tail{ m_consumer.m_tail.load(std::memory_order_acquire) };
+        std::size_t head{ m_producer.m_head.load(std::memory_order_acquire) };
+
+        return head - tail;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+private:
+    // producer: the index of the consumer is reloaded only if the cached one shows less than 'wanted' free slots
+    std::size_t freeSlots(std::size_t head, std::size_t wanted = 1)
+    {
+        std::size_t available{ Capacity - (head - m_producer.m_cachedTail) };
+
+        if (available < wanted) {
+            m_producer.m_cachedTail = m_consumer.m_tail.load(std::memory_order_acquire);
+            available = Capacity - (head - m_producer.m_cachedTail);
+        }
+
+        return available;
+    }
+
+    // consumer: the same for the index of the producer
+    std::size_t usedSlots(std::size_t tail, std::size_t wanted = 1)
+    {
+        std::size_t available{ m_consumer.m_cachedHead - tail };
+
+        if (available < wanted) {
+            m_consumer.m_cachedHead = m_producer.m_head.load(std::memory_order_acquire);
+            available = m_consumer.m_cachedHead - tail;
+        }
+
+        return available;
+    }
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
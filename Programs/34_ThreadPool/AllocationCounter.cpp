@@ -0,0 +1,127 @@
+// ===========================================================================
+// AllocationCounter.cpp // Counting heap allocations in benchmarks
+// ===========================================================================
+
+#include "AllocationCounter.h"
+
+#if defined(THREADPOOL_COUNT_ALLOCATIONS)
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<std::size_t> g_allocations{};
+
+static void* allocate(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr{ std::malloc(size == 0 ? 1 : size) }) {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+static void* allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    std::size_t align{ static_cast<std::size_t>(alignment) };
+
+#if defined(_MSC_VER)
+    void* ptr{ ::_aligned_malloc(size == 0 ? 1 : size, align) };
+#else
+    // std::aligned_alloc: the size has to be a multiple of the alignment
+    void* ptr{ std::aligned_alloc(align, (size + align - 1) / align * align) };
+#endif
+
+    if (ptr != nullptr) {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+static void release(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+static void releaseAligned(void* ptr) noexcept
+{
+#if defined(_MSC_VER)
+    ::_aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+// replaceable allocation functions: the nothrow variants forward to the throwing ones
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try { return allocateAligned(size, alignment); } catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try { return allocateAligned(size, alignment); } catch (...) { return nullptr; }
+}
+
+// replaceable deallocation functions
+void operator delete(void* ptr) noexcept { release(ptr); }
+void operator delete[](void* ptr) noexcept { release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept { releaseAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { releaseAligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { releaseAligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { releaseAligned(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(ptr); }
+
+bool AllocationCounter::enabled()
+{
+    return true;
+}
+
+std::size_t AllocationCounter::count()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool AllocationCounter::enabled()
+{
+    return false;
+}
+
+std::size_t AllocationCounter::count()
+{
+    return 0;
+}
+
+#endif
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
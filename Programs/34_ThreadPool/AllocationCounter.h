@@ -0,0 +1,24 @@
+// ===========================================================================
+// AllocationCounter.h // Counting heap allocations in benchmarks
+// ===========================================================================
+
+#pragma once
+
+#include <cstddef>
+
+// Replacing the global operator new changes the allocations of the whole program,
+// so counting is a compile-time option: defining THREADPOOL_COUNT_ALLOCATIONS (project wide)
+// replaces the complete operator new / delete set in AllocationCounter.cpp.
+// Otherwise the standard allocation functions are used and nothing is counted.
+
+namespace AllocationCounter
+{
+    bool enabled();
+
+    // number of calls of any operator new since program start
+    std::size_t count();
+}
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -0,0 +1,294 @@
+// ===========================================================================
+// Coroutine.h // Coroutines on top of the Thread Pool
+// ===========================================================================
+
+#pragma once
+
+#include "../Globals/MemoryPool.h"
+
+#include "Task.h"
+#include "TaskFuture.h"
+#include "ThreadPool.h"
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+// CoTask<T>: lazily started coroutine returning a value of type T.
+// A coroutine is moved onto a pool worker with 'co_await pool.schedule()',
+// it may 'co_await' other CoTask objects (resumed by symmetric transfer, no thread hops)
+// and TaskFuture objects (the coroutine is suspended, no thread blocks).
+// spawn(pool, task) starts a coroutine from ordinary code and returns a TaskFuture.
+// Coroutine frames are allocated from BlockPools (size classes), so suspending
+// and resuming a coroutine doesn't call malloc.
+
+namespace ThreadPoolDetail
+{
+    // frame allocation of all coroutine types of the thread pool
+    struct CoroutineFrame
+    {
+        template <std::size_t BlockSize>
+        static void* allocate(std::size_t size)
+        {
+            if constexpr (BlockSize > 4096) {
+                return ::operator new(size);
+            }
+            else if (size <= BlockSize) {
+                return BlockPool<BlockSize>::allocate();
+            }
+            else {
+                return allocate<2 * BlockSize>(size);
+            }
+        }
+
+        template <std::size_t BlockSize>
+        static void deallocate(void* ptr, std::size_t size)
+        {
+            if constexpr (BlockSize > 4096) {
+                ::operator delete(ptr);
+            }
+            else if (size <= BlockSize) {
+                BlockPool<BlockSize>::deallocate(ptr);
+            }
+            else {
+                deallocate<2 * BlockSize>(ptr, size);
+            }
+        }
+
+        static void* operator new(std::size_t size)
+        {
+            return allocate<128>(size);
+        }
+
+        static void operator delete(void* ptr, std::size_t size)
+        {
+            deallocate<128>(ptr, size);
+        }
+    };
+
+    template <typename T>
+    class CoTaskPromiseBase : public CoroutineFrame
+    {
+    protected:
+        std::variant<std::monostate, ResultType<T>, std::exception_ptr> m_result;
+        std::coroutine_handle<>                                        m_continuation;
+
+    public:
+        // resumes the awaiting coroutine (symmetric transfer)
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+
+            template <typename TPromise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) noexcept
+            {
+                std::coroutine_handle<> continuation{ handle.promise().m_continuation };
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void unhandled_exception()
+        {
+            m_result.template emplace<2>(std::current_exception());
+        }
+
+        void setContinuation(std::coroutine_handle<> continuation)
+        {
+            m_continuation = continuation;
+        }
+
+        ResultType<T> result()
+        {
+            if (m_result.index() == 2) {
+                std::rethrow_exception(std::get<2>(m_result));
+            }
+
+            return std::move(std::get<1>(m_result));
+        }
+    };
+
+    // coroutine without result, destroys itself when done
+    struct DetachedCoroutine
+    {
+        struct promise_type : public CoroutineFrame
+        {
+            DetachedCoroutine get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+}
+
+template <typename T>
+class CoTask
+{
+public:
+    struct promise_type : public ThreadPoolDetail::CoTaskPromiseBase<T>
+    {
+        CoTask get_return_object()
+        {
+            return CoTask{ std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+
+        template <typename TValue>
+        void return_value(TValue&& value)
+        {
+            this->m_result.template emplace<1>(std::forward<TValue>(value));
+        }
+    };
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+
+public:
+    // c'tors/d'tor
+    CoTask() : m_handle{ nullptr } {}
+
+    explicit CoTask(std::coroutine_handle<promise_type> handle) : m_handle{ handle } {}
+
+    ~CoTask()
+    {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    // move semantics only
+    CoTask(const CoTask&) = delete;
+    CoTask& operator=(const CoTask&) = delete;
+
+    CoTask(CoTask&& other) noexcept : m_handle{ std::exchange(other.m_handle, nullptr) } {}
+
+    CoTask& operator=(CoTask&& other) noexcept
+    {
+        if (&other != this) {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    // awaiting a CoTask starts it, the awaiting coroutine is resumed when it has finished
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter
+        {
+            std::coroutine_handle<promise_type> m_handle;
+
+            bool await_ready() noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                m_handle.promise().setContinuation(awaiting);
+                return m_handle;
+            }
+
+            T await_resume()
+            {
+                if constexpr (std::is_void_v<T>) {
+                    m_handle.promise().result();
+                }
+                else {
+                    return m_handle.promise().result();
+                }
+            }
+        };
+
+        return Awaiter{ m_handle };
+    }
+};
+
+template <>
+struct CoTask<void>::promise_type : public ThreadPoolDetail::CoTaskPromiseBase<void>
+{
+    CoTask get_return_object()
+    {
+        return CoTask{ std::coroutine_handle<promise_type>::from_promise(*this) };
+    }
+
+    void return_void()
+    {
+        m_result.emplace<1>();
+    }
+};
+
+// awaiting a TaskFuture suspends the coroutine, it is resumed on the pool when the result is available
+template <typename T>
+auto operator co_await(TaskFuture<T>& future)
+{
+    struct Awaiter
+    {
+        TaskFuture<T>& m_future;
+
+        bool await_ready() { return m_future.isReady(); }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_future.onReady(new Task{ [handle] () { handle.resume(); } });
+        }
+
+        T await_resume() { return m_future.get(); }
+    };
+
+    return Awaiter{ future };
+}
+
+template <typename T>
+auto operator co_await(TaskFuture<T>&& future)
+{
+    return operator co_await(future);   // the temporary lives until the end of the co_await expression
+}
+
+namespace ThreadPoolDetail
+{
+    template <typename T>
+    DetachedCoroutine runSpawned(ThreadPool& pool, CoTask<T> task, TaskPromise<T> promise)
+    {
+        co_await pool.schedule();
+
+        try
+        {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(task);
+                promise.setValue();
+            }
+            else {
+                promise.setValue(co_await std::move(task));
+            }
+        }
+        catch (...)
+        {
+            promise.setException(std::current_exception());
+        }
+    }
+}
+
+// starts a coroutine on the pool - the returned future becomes ready when it has finished
+template <typename T>
+TaskFuture<T> spawn(ThreadPool& pool, CoTask<T> task)
+{
+    TaskPromise<T> promise{ &pool };
+
+    auto future{ promise.getFuture() };
+
+    ThreadPoolDetail::runSpawned(pool, std::move(task), std::move(promise));
+
+    return future;
+}
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -2,17 +2,36 @@
 // Examples.cpp // Thread Pool
 // ===========================================================================
 
+#include "../Logger/LatencyHistogram.h"
 #include "../Logger/Logger.h"
 #include "../Logger/ScopedTimer.h"
+#include "../Logger/TraceScope.h"
 
 #include "../Globals/GlobalPrimes.h"
 #include "../Globals/IsPrime.h"
 
+#include "AllocationCounter.h"
+#include "Coroutine.h"
+#include "LockFreeTaskQueue.h"
+#include "TaskGraph.h"
+#include "TaskQueue.h"
 #include "ThreadPool.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <latch>
 #include <iostream>
 #include <print>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 // ===========================================================================
@@ -70,6 +89,88 @@ void test_concurrency_thread_pool02()
     Logger::log(std::cout, "Done.");
 }
 
+// ===========================================================================
+// benchmark: heap allocations per task and tasks per second,
+// comparing addTask (std::future) and submit (TaskFuture)
+
+// allocations per operation - "n/a" unless allocations are counted (see AllocationCounter.h)
+static std::string allocationsPer(std::size_t allocations, std::size_t operations)
+{
+    if (!AllocationCounter::enabled()) {
+        return "n/a";
+    }
+
+    std::ostringstream ss;
+    ss << static_cast<double>(allocations) / operations;
+    return ss.str();
+}
+
+static constexpr std::size_t NumBenchmarkTasks{ 1'000'000 };
+
+template <typename TFuture, typename TSubmit>
+static void runEmptyTasks(ThreadPool& pool, std::vector<TFuture>& futures, TSubmit submit)
+{
+    futures.clear();
+
+    for (std::size_t n{}; n != NumBenchmarkTasks; ++n) {
+        futures.push_back(submit(pool));
+    }
+
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+template <typename TFuture, typename TSubmit>
+static void benchmarkEmptyTasks(std::string_view name, TSubmit submit, TaskQueuePolicy policy = TaskQueuePolicy::Mutex)
+{
+    ThreadPool pool{ policy };
+
+    pool.start();
+
+    std::vector<TFuture> futures;
+    futures.reserve(NumBenchmarkTasks);
+
+    Logger::enableLogging(false);
+
+    // first run warms up memory pools and queue buffers
+    runEmptyTasks(pool, futures, submit);
+
+    std::size_t allocations{ AllocationCounter::count() };
+    auto begin{ std::chrono::steady_clock::now() };
+
+    runEmptyTasks(pool, futures, submit);
+
+    auto end{ std::chrono::steady_clock::now() };
+    allocations = AllocationCounter::count() - allocations;
+
+    Logger::enableLogging(true);
+
+    pool.stop();
+
+    std::chrono::duration<double> seconds{ end - begin };
+
+    Logger::log(std::cout, name, ": Allocations per task: ",
+        allocationsPer(allocations, NumBenchmarkTasks));
+    Logger::log(std::cout, name, ": Tasks per second:     ",
+        static_cast<std::size_t>(NumBenchmarkTasks / seconds.count()));
+}
+
+void test_concurrency_thread_pool07()
+{
+    Logger::log(std::cout, "Start");
+
+    benchmarkEmptyTasks<std::future<void>>(
+        "addTask", [](ThreadPool& pool) { return pool.addTask(emptyTask); }
+    );
+
+    benchmarkEmptyTasks<TaskFuture<void>>(
+        "submit ", [](ThreadPool& pool) { return pool.submit(emptyTask); }
+    );
+
+    Logger::log(std::cout, "Done.");
+}
+
 // ===========================================================================
 
 static void calcChecksumWeak(std::size_t num, std::size_t* checksum)
@@ -180,6 +281,1220 @@ void test_concurrency_thread_pool05()
     Logger::log(std::cout, "Done.");
 }
 
+// ===========================================================================
+// tasks launching tasks: submitted from inside a worker they are pushed
+// onto the worker's own deque, idle workers steal them
+
+static constexpr std::size_t SpawnDepth{ 16 };
+
+static void spawnTasks(ThreadPool& pool, std::size_t depth, std::atomic<std::size_t>& counter)
+{
+    ++counter;
+
+    if (depth == 0) {
+        return;
+    }
+
+    pool.addTask(spawnTasks, std::ref(pool), depth - 1, std::ref(counter));
+    pool.addTask(spawnTasks, std::ref(pool), depth - 1, std::ref(counter));
+}
+
+void test_concurrency_thread_pool06()
+{
+    Logger::log(std::cout, "Start");
+
+    ThreadPool pool{};
+
+    std::atomic<std::size_t> counter{};
+
+    pool.start();
+
+    Logger::enableLogging(false);
+    {
+        ScopedTimer clock{};
+
+        pool.addTask(spawnTasks, std::ref(pool), SpawnDepth, std::ref(counter));
+        pool.stop();
+    }
+    Logger::enableLogging(true);
+
+    Logger::log(std::cout, "Executed Tasks:  ", counter.load());
+    Logger::log(std::cout, "Expected Tasks:  ", (std::size_t{ 1 } << (SpawnDepth + 1)) - 1);
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// bulk submission: one lock and one wakeup per batch instead of per task
+
+static constexpr std::size_t NumBulkTasks{ 100'000 };
+
+void test_concurrency_thread_pool08()
+{
+    Logger::log(std::cout, "Start");
+
+    std::atomic<std::size_t> checksum{};
+
+    auto calcChecksum = [&] (std::size_t num) { checksum += num; };
+
+    ThreadPool pool{};
+
+    pool.start();
+
+    Logger::enableLogging(false);
+
+    // 1. single submissions
+    std::vector<std::future<void>> results;
+    results.reserve(NumBulkTasks);
+
+    auto begin{ std::chrono::steady_clock::now() };
+
+    for (std::size_t n{}; n != NumBulkTasks; ++n) {
+        results.push_back(pool.addTask(calcChecksum, n));
+    }
+
+    auto end{ std::chrono::steady_clock::now() };
+    auto singleSubmit{ std::chrono::duration_cast<std::chrono::microseconds>(end - begin) };
+
+    for (auto& future : results) {
+        future.get();
+    }
+
+    // 2. range of callables
+    std::vector<std::move_only_function<void()>> callables;
+    callables.reserve(NumBulkTasks);
+
+    for (std::size_t n{}; n != NumBulkTasks; ++n) {
+        callables.push_back([&, n] () { calcChecksum(n); });
+    }
+
+    begin = std::chrono::steady_clock::now();
+
+    results = pool.addTasks(std::move(callables));
+
+    end = std::chrono::steady_clock::now();
+    auto rangeSubmit{ std::chrono::duration_cast<std::chrono::microseconds>(end - begin) };
+
+    for (auto& future : results) {
+        future.get();
+    }
+
+    // 3. index range and a functor, one aggregate completion handle
+    begin = std::chrono::steady_clock::now();
+
+    TaskFuture<void> done{ pool.addTasks(std::size_t{}, NumBulkTasks, calcChecksum) };
+
+    end = std::chrono::steady_clock::now();
+    auto indexSubmit{ std::chrono::duration_cast<std::chrono::microseconds>(end - begin) };
+
+    done.get();
+
+    Logger::enableLogging(true);
+
+    pool.stop();
+
+    Logger::log(std::cout, "Submitting ", NumBulkTasks, " tasks:");
+    Logger::log(std::cout, "addTask (single):       ", singleSubmit.count(), " [microseconds]");
+    Logger::log(std::cout, "addTasks (range):       ", rangeSubmit.count(), " [microseconds]");
+    Logger::log(std::cout, "addTasks (index range): ", indexSubmit.count(), " [microseconds]");
+    Logger::log(std::cout, "Checksum:               ", checksum.load());
+    Logger::log(std::cout, "Expected Checksum:      ", 3 * (NumBulkTasks * (NumBulkTasks - 1) / 2));
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// nested parallelism: tasks waiting for the results of other tasks.
+// Using future.get() all workers would block sooner or later (deadlock),
+// waitFor executes queued tasks while the result isn't ready.
+
+static std::size_t parallelSum(ThreadPool& pool, std::size_t first, std::size_t last)
+{
+    if (last - first <= 1'000) {
+        std::size_t sum{};
+        for (std::size_t n{ first }; n != last; ++n) {
+            sum += n;
+        }
+        return sum;
+    }
+
+    std::size_t middle{ first + (last - first) / 2 };
+
+    auto future{ pool.submit(parallelSum, std::ref(pool), first, middle) };
+
+    std::size_t sum{ parallelSum(pool, middle, last) };
+
+    return sum + pool.waitFor(future);
+}
+
+void test_concurrency_thread_pool09()
+{
+    Logger::log(std::cout, "Start");
+
+    constexpr std::size_t Last{ 10'000'000 };
+
+    ThreadPool pool{};
+
+    pool.start();
+
+    Logger::enableLogging(false);
+
+    std::size_t sum{};
+    {
+        ScopedTimer clock{};
+
+        auto future{ pool.submit(parallelSum, std::ref(pool), std::size_t{}, Last) };
+        sum = pool.waitFor(future);
+    }
+
+    Logger::enableLogging(true);
+
+    pool.stop();
+
+    Logger::log(std::cout, "Sum:          ", sum);
+    Logger::log(std::cout, "Expected Sum: ", Last * (Last - 1) / 2);
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// benchmark: latency of high priority tasks while the pool is saturated
+// with background tasks (enqueue-to-start time, p50 / p99 / max),
+// deadline tasks missing their deadline while the pool is saturated with normal tasks
+
+static void busyWait(std::chrono::microseconds duration)
+{
+    auto end{ std::chrono::steady_clock::now() + duration };
+    while (std::chrono::steady_clock::now() < end) {}
+}
+
+static void measureLatencies(std::string_view name, TaskPriority probePriority)
+{
+    constexpr std::chrono::microseconds BackgroundTaskDuration{ 50 };
+    constexpr std::size_t NumProbes{ 200 };
+
+    ThreadPool pool{};
+
+    pool.start();
+
+    Logger::enableLogging(false);
+
+    // twice the amount of work the pool is able to do while probing
+    std::size_t numBackgroundTasks{ 2 * std::thread::hardware_concurrency() * 
+        (NumProbes * 1'000 / BackgroundTaskDuration.count()) };
+
+    for (std::size_t n{}; n != numBackgroundTasks; ++n) {
+        pool.addTask(TaskPriority::Background, busyWait, BackgroundTaskDuration);
+    }
+
+    std::vector<std::future<std::chrono::nanoseconds>> probes;
+
+    for (std::size_t n{}; n != NumProbes; ++n)
+    {
+        auto submitted{ std::chrono::steady_clock::now() };
+
+        probes.push_back(pool.addTask(probePriority, [submitted] () {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - submitted);
+        }));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+
+    std::vector<std::chrono::nanoseconds> latencies;
+    for (auto& probe : probes) {
+        latencies.push_back(probe.get());
+    }
+
+    pool.stop();
+
+    Logger::enableLogging(true);
+
+    std::sort(latencies.begin(), latencies.end());
+
+    auto micros = [] (std::chrono::nanoseconds latency) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    };
+
+    Logger::log(std::cout, name, ": p50: ", micros(latencies[latencies.size() / 2]),
+        " - p99: ", micros(latencies[latencies.size() * 99 / 100]),
+        " - max: ", micros(latencies.back()), " [microseconds]");
+}
+
+static void measureDeadlines(std::string_view name, TaskPriority priority)
+{
+    constexpr std::chrono::microseconds TaskDuration{ 50 };
+    constexpr std::chrono::milliseconds Slack{ 2 };
+    constexpr std::size_t NumProbes{ 200 };
+
+    ThreadPool pool{};
+
+    pool.start();
+
+    Logger::enableLogging(false);
+
+    // FIFO backlog of the same lane: twice the amount of work the pool is able to do while probing
+    std::size_t numTasks{ 2 * std::thread::hardware_concurrency() *
+        (NumProbes * 1'000 / TaskDuration.count()) };
+
+    for (std::size_t n{}; n != numTasks; ++n) {
+        pool.addTask(priority, busyWait, TaskDuration);
+    }
+
+    std::vector<std::future<bool>> probes;
+
+    for (std::size_t n{}; n != NumProbes; ++n)
+    {
+        auto deadline{ std::chrono::steady_clock::now() + Slack };
+
+        probes.push_back(pool.addTask(priority, deadline, [deadline] () {
+            return std::chrono::steady_clock::now() > deadline;
+        }));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+
+    std::size_t missed{};
+    for (auto& probe : probes) {
+        missed += probe.get() ? 1 : 0;
+    }
+
+    pool.stop();
+
+    Logger::enableLogging(true);
+
+    Logger::log(std::cout, name, ": ", missed, " of ", NumProbes, " started after their deadline (",
+        Slack.count(), " milliseconds)");
+}
+
+void test_concurrency_thread_pool13()
+{
+    Logger::log(std::cout, "Start");
+
+    measureLatencies("High priority probes      ", TaskPriority::High);
+    measureLatencies("Background priority probes", TaskPriority::Background);
+
+    measureDeadlines("High priority deadlines  ", TaskPriority::High);
+    measureDeadlines("Normal priority deadlines", TaskPriority::Normal);
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// configured start: number of workers, one logical processor per worker
+// and thread names "pool-worker-<n>" (visible in debuggers and profilers)
+
+void test_concurrency_thread_pool14()
+{
+    Logger::log(std::cout, "Start");
+
+    std::size_t numCpus{ std::max(std::thread::hardware_concurrency(), 1u) };
+
+    ThreadPoolConfig config{};
+    config.m_threadsCount = 4;
+    config.m_namePrefix = "pool-worker-";
+
+    for (std::size_t cpu{}; cpu != config.m_threadsCount; ++cpu) {
+        config.m_cpuSets.push_back({ cpu % numCpus });
+    }
+
+    ThreadPool pool{};
+
+    pool.start(config);
+
+    Logger::log(std::cout, "Workers: ", pool.threadsCount());
+
+    std::atomic<std::size_t> counter{};
+
+    auto future{ pool.addTasks(0, 1'000, [&] (int) { counter++; }) };
+    pool.waitFor(future);
+
+    pool.stop();
+
+    Logger::log(std::cout, "Counter: ", counter);
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// elastic mode: tasks blocking (here: sleeping) for a long time saturate the pool,
+// additional workers are spawned - and retire after the keep-alive timeout
+
+void test_concurrency_thread_pool15()
+{
+    Logger::log(std::cout, "Start");
+
+    ThreadPoolConfig config{};
+    config.m_threadsCount = 2;
+    config.m_maxThreadsCount = 8;
+    config.m_growThreshold = std::chrono::milliseconds{ 20 };
+    config.m_keepAlive = std::chrono::milliseconds{ 200 };
+
+    ThreadPool pool{};
+
+    pool.start(config);
+
+    Logger::enableLogging(false);
+
+    std::vector<TaskFuture<void>> futures;
+
+    for (std::size_t n{}; n != 32; ++n) {
+        futures.push_back(pool.submit([] () {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 100 });   // "blocking I/O"
+        }));
+    }
+
+    Logger::enableLogging(true);
+
+    {
+        ScopedTimer clock{};
+
+        for (auto& future : futures) {
+            future.get();
+        }
+    }
+
+    Logger::log(std::cout, "Threads: ", pool.threadsCount(), " - grown: ", pool.growCount(), " - shrunk: ", pool.shrinkCount());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 500 });
+
+    Logger::log(std::cout, "Threads: ", pool.threadsCount(), " - grown: ", pool.growCount(), " - shrunk: ", pool.shrinkCount());
+
+    pool.stop();
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// benchmark: injection queue policies - mutex protected ring buffer (TaskQueue)
+// vs. lock-free ring buffer (LockFreeTaskQueue), enqueue and dequeue latencies
+// with 1, 4, 16 and 64 producers and 4 consumers - and the complete pool with either policy
+// (TaskQueuePolicy), 1.000.000 empty tasks submitted from outside the pool.
+
+static constexpr std::size_t NumQueueOperations{ 256 * 1024 };
+static constexpr std::size_t NumQueueConsumers{ 4 };
+
+static void printLatencies(std::string_view name, std::vector<std::chrono::nanoseconds>& latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+
+    Logger::log(std::cout, name,
+        "p50: ", latencies[latencies.size() / 2].count(),
+        " - p99: ", latencies[latencies.size() * 99 / 100].count(),
+        " - p999: ", latencies[latencies.size() * 999 / 1000].count(),
+        " - max: ", latencies.back().count(), " [nanoseconds]");
+}
+
+template <typename TQueue>
+static void benchmarkQueue(std::string_view name, std::size_t numProducers)
+{
+    TQueue queue{};
+
+    Task dummy{ [] () {} };   // all pushed pointers refer to the same task, it is never executed
+
+    std::size_t operationsPerProducer{ NumQueueOperations / numProducers };
+
+    std::vector<std::vector<std::chrono::nanoseconds>> enqueueLatencies(numProducers);
+    std::vector<std::vector<std::chrono::nanoseconds>> dequeueLatencies(NumQueueConsumers);
+
+    std::atomic<std::size_t> remaining{ operationsPerProducer * numProducers };
+
+    std::latch start{ static_cast<std::ptrdiff_t>(numProducers + NumQueueConsumers) };
+
+    std::vector<std::jthread> threads;
+
+    for (std::size_t i{}; i != numProducers; ++i)
+    {
+        threads.emplace_back([&, i] () {
+            auto& latencies{ enqueueLatencies[i] };
+            latencies.reserve(operationsPerProducer);
+            start.arrive_and_wait();
+
+            for (std::size_t n{}; n != operationsPerProducer; ++n) {
+                auto begin{ std::chrono::steady_clock::now() };
+                queue.push(&dummy);
+                latencies.push_back(std::chrono::steady_clock::now() - begin);
+            }
+        });
+    }
+
+    for (std::size_t i{}; i != NumQueueConsumers; ++i)
+    {
+        threads.emplace_back([&, i] () {
+            auto& latencies{ dequeueLatencies[i] };
+            latencies.reserve(NumQueueOperations);
+            start.arrive_and_wait();
+
+            while (remaining != 0) {
+                auto begin{ std::chrono::steady_clock::now() };
+                Task* task{ queue.pop() };
+                auto end{ std::chrono::steady_clock::now() };
+
+                if (task != nullptr) {
+                    latencies.push_back(end - begin);
+                    remaining--;
+                }
+            }
+        });
+    }
+
+    threads.clear();   // joins all threads
+
+    std::vector<std::chrono::nanoseconds> enqueue;
+    for (auto& latencies : enqueueLatencies) {
+        enqueue.insert(enqueue.end(), latencies.begin(), latencies.end());
+    }
+
+    std::vector<std::chrono::nanoseconds> dequeue;
+    for (auto& latencies : dequeueLatencies) {
+        dequeue.insert(dequeue.end(), latencies.begin(), latencies.end());
+    }
+
+    Logger::log(std::cout, name, " - ", numProducers, " producers:");
+    printLatencies("  enqueue: ", enqueue);
+    printLatencies("  dequeue: ", dequeue);
+}
+
+void test_concurrency_thread_pool16()
+{
+    Logger::log(std::cout, "Start");
+
+    for (std::size_t numProducers : { 1, 4, 16, 64 })
+    {
+        benchmarkQueue<TaskQueue>("TaskQueue (mutex)    ", numProducers);
+        benchmarkQueue<LockFreeTaskQueue<>>("LockFreeTaskQueue    ", numProducers);
+    }
+
+    benchmarkEmptyTasks<TaskFuture<void>>(
+        "ThreadPool (mutex)    ", [](ThreadPool& pool) { return pool.submit(emptyTask); }, TaskQueuePolicy::Mutex
+    );
+
+    benchmarkEmptyTasks<TaskFuture<void>>(
+        "ThreadPool (lock-free)", [](ThreadPool& pool) { return pool.submit(emptyTask); }, TaskQueuePolicy::LockFree
+    );
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// continuations: multi-stage pipelines without blocking a thread per stage,
+// combining futures with whenAll and whenAny
+
+void test_concurrency_thread_pool17()
+{
+    Logger::log(std::cout, "Start");
+
+    constexpr std::size_t NumPipelines{ 1'000 };
+
+    ThreadPool pool{};
+
+    pool.start();
+
+    Logger::enableLogging(false);
+
+    std::vector<TaskFuture<std::size_t>> pipelines;
+
+    for (std::size_t n{}; n != NumPipelines; ++n)
+    {
+        // stage 1: produce - stage 2: transform - stage 3: check
+        auto future{ pool.submit([n] () { return n; })
+            .then([] (std::size_t value) { return value * value; })
+            .then([] (std::size_t value) { return PrimeNumbers::IsPrime(value + 1) ? std::size_t{ 1 } : std::size_t{ 0 }; })
+        };
+
+        pipelines.push_back(std::move(future));
+    }
+
+    // summing up is a continuation too - the main thread waits only for the very last result
+    auto total{ whenAll(std::move(pipelines)).then(
+        [] (std::vector<TaskFuture<std::size_t>> results) {
+            std::size_t sum{};
+            for (auto& result : results) {
+                sum += result.get();
+            }
+            return sum;
+        }
+    ) };
+
+    std::size_t primes{ total.get() };
+
+    // an exception is forwarded along the chain, the continuation is skipped
+    auto failed{ pool.submit([] () -> int { throw std::runtime_error{ "stage 1 failed" }; })
+        .then([] (int value) { return value + 1; })
+    };
+
+    // first of several results
+    std::vector<TaskFuture<int>> racers;
+    racers.push_back(pool.submit([] () { std::this_thread::sleep_for(std::chrono::milliseconds{ 200 }); return 1; }));
+    racers.push_back(pool.submit([] () { return 2; }));
+
+    auto first{ whenAny(std::move(racers)).get() };
+
+    Logger::enableLogging(true);
+
+    Logger::log(std::cout, "Values n*n+1 being prime (n < ", NumPipelines, "): ", primes);
+
+    try {
+        failed.get();
+    }
+    catch (const std::exception& ex) {
+        Logger::log(std::cout, "Exception forwarded: ", ex.what());
+    }
+
+    Logger::log(std::cout, "First ready future: ", first.m_index, " - value: ", first.m_futures[first.m_index].get());
+
+    pool.stop();
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// task graph: a layered graph (every node depends on two random nodes of the previous layer,
+// costs vary) executed level by level with barriers vs. as a task graph,
+// which is built once and run repeatedly
+
+static constexpr std::size_t NumGraphLayers{ 16 };
+static constexpr std::size_t NumGraphNodesPerLayer{ 16 };
+static constexpr std::size_t NumGraphRuns{ 20 };
+
+struct GraphNodeSpec
+{
+    std::chrono::microseconds   m_duration;
+    std::size_t                 m_predecessors[2];
+};
+
+static std::vector<std::vector<GraphNodeSpec>> makeLayers()
+{
+    std::mt19937 generator{ 4711 };
+    std::uniform_int_distribution<int> duration{ 10, 400 };
+    std::uniform_int_distribution<std::size_t> predecessor{ 0, NumGraphNodesPerLayer - 1 };
+
+    std::vector<std::vector<GraphNodeSpec>> layers(NumGraphLayers);
+
+    for (auto& layer : layers) {
+        for (std::size_t n{}; n != NumGraphNodesPerLayer; ++n) {
+            layer.push_back(GraphNodeSpec{ std::chrono::microseconds{ duration(generator) }, { predecessor(generator), predecessor(generator) } });
+        }
+    }
+
+    return layers;
+}
+
+static void runGraph(std::string_view name, ThreadPool& pool, const std::vector<std::vector<GraphNodeSpec>>& layers, GraphOrdering ordering)
+{
+    TaskGraph graph{ ordering };
+
+    std::vector<TaskGraph::NodeId> previous;
+
+    for (const auto& layer : layers)
+    {
+        std::vector<TaskGraph::NodeId> current;
+
+        for (const auto& spec : layer)
+        {
+            auto duration{ spec.m_duration };
+            TaskGraph::NodeId id{ graph.addNode([duration] () { busyWait(duration); }, static_cast<std::size_t>(duration.count())) };
+
+            if (!previous.empty()) {
+                graph.addEdge(previous[spec.m_predecessors[0]], id);
+                if (spec.m_predecessors[1] != spec.m_predecessors[0]) {
+                    graph.addEdge(previous[spec.m_predecessors[1]], id);
+                }
+            }
+
+            current.push_back(id);
+        }
+
+        previous = std::move(current);
+    }
+
+    Logger::enableLogging(false);
+
+    // first run prepares the graph and warms up the memory pools
+    auto future{ graph.run(pool) };
+    pool.waitFor(future);
+
+    std::size_t allocations{ AllocationCounter::count() };
+    auto begin{ std::chrono::steady_clock::now() };
+
+    for (std::size_t run{}; run != NumGraphRuns; ++run) {
+        auto future{ graph.run(pool) };
+        pool.waitFor(future);
+    }
+
+    auto end{ std::chrono::steady_clock::now() };
+    allocations = AllocationCounter::count() - allocations;
+
+    Logger::enableLogging(true);
+
+    Logger::log(std::cout, name, ": ", std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / NumGraphRuns,
+        " [microseconds per run] - allocations per run: ", allocationsPer(allocations, NumGraphRuns),
+        " - critical path: ", graph.criticalPath(), " [microseconds]");
+}
+
+static void runLayers(std::string_view name, ThreadPool& pool, const std::vector<std::vector<GraphNodeSpec>>& layers)
+{
+    Logger::enableLogging(false);
+
+    auto begin{ std::chrono::steady_clock::now() };
+
+    for (std::size_t run{}; run != NumGraphRuns; ++run)
+    {
+        for (const auto& layer : layers)
+        {
+            auto future{ pool.addTasks(std::size_t{}, layer.size(), [&] (std::size_t n) { busyWait(layer[n].m_duration); }) };
+            pool.waitFor(future);   // barrier
+        }
+    }
+
+    auto end{ std::chrono::steady_clock::now() };
+
+    Logger::enableLogging(true);
+
+    Logger::log(std::cout, name, ": ", std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / NumGraphRuns,
+        " [microseconds per run]");
+}
+
+void test_concurrency_thread_pool18()
+{
+    Logger::log(std::cout, "Start");
+
+    auto layers{ makeLayers() };
+
+    ThreadPool pool{};
+
+    pool.start();
+
+    runLayers("Level by level (barriers) ", pool, layers);
+    runGraph ("Task graph                ", pool, layers, GraphOrdering::Insertion);
+    runGraph ("Task graph (critical path)", pool, layers, GraphOrdering::CriticalPathFirst);
+
+    pool.stop();
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// coroutines: CoTask, co_await pool.schedule() and co_await on TaskFuture objects
+
+static CoTask<std::size_t> countPrimes(ThreadPool& pool, std::size_t first, std::size_t last)
+{
+    co_await pool.schedule();   // from here on: running on a worker
+
+    std::size_t count{};
+    for (std::size_t n{ first }; n != last; ++n) {
+        if (PrimeNumbers::IsPrime(n)) {
+            ++count;
+        }
+    }
+
+    co_return count;
+}
+
+static CoTask<std::size_t> countPrimesParallel(ThreadPool& pool, std::size_t last, std::size_t chunks)
+{
+    co_await pool.schedule();
+
+    // spawned coroutines run concurrently, awaiting their futures doesn't block a worker
+    std::vector<TaskFuture<std::size_t>> futures;
+    for (std::size_t i{}; i != chunks; ++i) {
+        futures.push_back(spawn(pool, countPrimes(pool, i * last / chunks, (i + 1) * last / chunks)));
+    }
+
+    std::size_t count{};
+    for (auto& future : futures) {
+        count += co_await future;
+    }
+
+    // a task submitted in the classic way can be awaited as well
+    std::size_t extra{ co_await pool.submit([] () { return std::size_t{ 0 }; }) };
+
+    co_return count + extra;
+}
+
+static CoTask<std::size_t> hopAround(ThreadPool& pool, std::size_t hops)
+{
+    for (std::size_t n{}; n != hops; ++n) {
+        co_await pool.schedule();
+    }
+
+    co_return hops;
+}
+
+void test_concurrency_thread_pool19()
+{
+    Logger::log(std::cout, "Start");
+
+    constexpr std::size_t NumHops{ 100'000 };
+
+    ThreadPool pool{};
+
+    pool.start();
+
+    Logger::enableLogging(false);
+
+    auto primes{ spawn(pool, countPrimesParallel(pool, 1'000'000, 16)) };
+    std::size_t count{ pool.waitFor(primes) };
+
+    // warming up the memory pools, then counting the allocations of suspend/resume cycles
+    auto warmUp{ spawn(pool, hopAround(pool, NumHops)) };
+    pool.waitFor(warmUp);
+
+    std::size_t allocations{ AllocationCounter::count() };
+    auto begin{ std::chrono::steady_clock::now() };
+
+    auto hops{ spawn(pool, hopAround(pool, NumHops)) };
+    pool.waitFor(hops);
+
+    auto end{ std::chrono::steady_clock::now() };
+    allocations = AllocationCounter::count() - allocations;
+
+    Logger::enableLogging(true);
+
+    pool.stop();
+
+    Logger::log(std::cout, "Prime numbers below 1.000.000: ", count);
+    Logger::log(std::cout, "Suspend/resume cycles per second: ",
+        static_cast<std::size_t>(NumHops / std::chrono::duration<double>(end - begin).count()),
+        " - allocations per cycle: ", allocationsPer(allocations, NumHops));
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// delayed and periodic tasks: scheduleAfter / scheduleEvery, cancellation,
+// benchmark: inserting and cancelling 1.000.000 pending timers (hierarchical timer wheel)
+
+// the timer thread sleeps until the pending timer expires - a shorter timer has to wake it up
+static void measureShortTimer()
+{
+    ThreadPool pool{};
+
+    pool.start();
+
+    TimerHandle pending{ pool.scheduleAfter(std::chrono::seconds{ 10 }, [] () {}) };
+
+    // let the timer thread go to sleep
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+
+    auto start{ std::chrono::steady_clock::now() };
+    std::promise<long long> delayedAt{};
+
+    pool.scheduleAfter(std::chrono::milliseconds{ 10 }, [&] () {
+        delayedAt.set_value(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    });
+
+    long long msecs{ delayedAt.get_future().get() };
+
+    pending.cancel();
+
+    pool.stop();
+
+    Logger::log(std::cout, "Task scheduled after 10 ms, while a 10 s timer is pending, ran after ", msecs, " [milliseconds]");
+}
+
+void test_concurrency_thread_pool20()
+{
+    Logger::log(std::cout, "Start");
+
+    measureShortTimer();
+
+    constexpr std::size_t NumTimers{ 1'000'000 };
+
+    ThreadPool pool{};
+
+    pool.start();
+
+    Logger::enableLogging(false);
+
+    std::mt19937 generator{ 4711 };
+    std::uniform_int_distribution<int> delay{ 1'000, 60'000 };
+
+    std::vector<TimerHandle> handles;
+    handles.reserve(NumTimers);
+
+    auto begin{ std::chrono::steady_clock::now() };
+
+    for (std::size_t n{}; n != NumTimers; ++n) {
+        handles.push_back(pool.scheduleAfter(std::chrono::milliseconds{ delay(generator) }, [] () {}));
+    }
+
+    auto end{ std::chrono::steady_clock::now() };
+
+    auto insertion{ std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / NumTimers };
+
+    // timers are still precise with 1.000.000 pending timers
+    auto start{ std::chrono::steady_clock::now() };
+    std::atomic<long long> delayedAt{};
+    std::atomic<std::size_t> ticks{};
+
+    pool.scheduleAfter(std::chrono::milliseconds{ 50 }, [&] () {
+        delayedAt = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    });
+
+    TimerHandle ticker{ pool.scheduleEvery(std::chrono::milliseconds{ 10 }, [&] () { ticks++; }) };
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 205 });
+
+    ticker.cancel();
+
+    begin = std::chrono::steady_clock::now();
+
+    std::size_t cancelled{};
+    for (auto& handle : handles) {
+        if (handle.cancel()) {
+            ++cancelled;
+        }
+    }
+
+    end = std::chrono::steady_clock::now();
+
+    auto cancellation{ std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / NumTimers };
+
+    Logger::enableLogging(true);
+
+    pool.stop();
+
+    Logger::log(std::cout, "Inserting ", NumTimers, " timers: ", insertion, " [nanoseconds per timer]");
+    Logger::log(std::cout, "Cancelling ", cancelled, " timers: ", cancellation, " [nanoseconds per timer]");
+    Logger::log(std::cout, "Task scheduled after 50 ms ran after ", delayedAt.load(), " [milliseconds]");
+    Logger::log(std::cout, "Periodic task (10 ms) ran ", ticks.load(), " times within 205 ms");
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// runtime statistics: per worker counters and queue wait times (enqueue to start)
+
+void test_concurrency_thread_pool21()
+{
+    Logger::log(std::cout, "Start");
+
+    constexpr std::size_t NumTasks{ 1'000'000 };
+
+    ThreadPool pool{};
+
+    pool.start();
+
+    Logger::enableLogging(false);
+
+    // 1.: cost of empty tasks, including the instrumentation
+    auto begin{ std::chrono::steady_clock::now() };
+
+    pool.addTasks(std::size_t{}, NumTasks, [] (std::size_t) {}).get();
+
+    auto end{ std::chrono::steady_clock::now() };
+
+    auto perTask{ std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / NumTasks };
+
+    // 2.: some real work, submitted from outside and from inside the pool
+    std::vector<TaskFuture<std::size_t>> futures;
+
+    for (std::size_t n{}; n != 1'000; ++n)
+    {
+        futures.push_back(pool.submit([&pool, n] () {
+            auto inner{ pool.submit([n] () {
+                return PrimeNumbers::IsPrime(1'000'000'000'000'000 + n) ? std::size_t{ 1 } : std::size_t{ 0 };
+            }) };
+            return pool.waitFor(inner);
+        }));
+    }
+
+    for (auto& future : futures) {
+        future.get();
+    }
+
+    ThreadPoolStatistics statistics{ pool.snapshot() };
+
+    Logger::enableLogging(true);
+
+    pool.stop();
+
+    Logger::log(std::cout, "Empty tasks: ", perTask, " [nanoseconds per task]",
+        ThreadPoolStatisticsEnabled ? " (statistics enabled)" : " (statistics disabled)");
+
+    auto milliseconds = [] (std::chrono::nanoseconds duration) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+    };
+
+    for (std::size_t i{}; i != statistics.m_workers.size(); ++i)
+    {
+        const WorkerStatistics& worker{ statistics.m_workers[i] };
+
+        Logger::log(std::cout, "Worker ", i, ": ", worker.m_tasksExecuted, " tasks (local ", worker.m_localPops,
+            ", queue ", worker.m_queuePops, ", stolen ", worker.m_steals, "), busy ", milliseconds(worker.m_busyTime),
+            " ms, idle ", milliseconds(worker.m_idleTime), " ms, max. queue depth ", worker.m_maxQueueDepth);
+    }
+
+    Logger::log(std::cout, "Total:    ", statistics.m_total.m_tasksExecuted, " tasks, ",
+        statistics.m_externalTasks, " executed outside of the pool");
+
+    Logger::log(std::cout, "Queue wait: 50% < ", statistics.queueWaitPercentile(0.5).count(),
+        " ns, 99% < ", statistics.queueWaitPercentile(0.99).count(),
+        " ns, 100% < ", statistics.queueWaitPercentile(1.0).count(), " [nanoseconds]");
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// shutdown modes: draining, discarding pending tasks, cancelling running tasks
+
+static void shutdownPool(ShutdownMode mode, const char* name)
+{
+    constexpr std::size_t NumTasks{ 1'000 };
+
+    ThreadPool pool{};
+
+    pool.start();
+
+    Logger::enableLogging(false);
+
+    std::vector<std::future<std::size_t>> futures;
+
+    // long running tasks observing the stop token of the pool
+    for (std::size_t n{}; n != pool.threadsCount(); ++n)
+    {
+        futures.push_back(pool.addTask([] (std::stop_token token) {
+            std::size_t rounds{};
+            while (!token.stop_requested() && rounds != 200) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+                ++rounds;
+            }
+            return rounds;
+        }));
+    }
+
+    // backlog
+    for (std::size_t n{}; n != NumTasks; ++n)
+    {
+        futures.push_back(pool.addTask([] () {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+            return std::size_t{ 1 };
+        }));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+
+    auto begin{ std::chrono::steady_clock::now() };
+
+    pool.stop(mode);
+
+    auto end{ std::chrono::steady_clock::now() };
+
+    Logger::enableLogging(true);
+
+    std::size_t completed{};
+    std::size_t broken{};
+
+    for (auto& future : futures)
+    {
+        try
+        {
+            future.get();
+            ++completed;
+        }
+        catch (const std::future_error& error)
+        {
+            if (error.code() == std::future_errc::broken_promise) {
+                ++broken;
+            }
+        }
+    }
+
+    Logger::log(std::cout, name, ": stop took ", std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count(),
+        " ms, ", completed, " tasks completed, ", broken, " broken promises");
+}
+
+void test_concurrency_thread_pool22()
+{
+    Logger::log(std::cout, "Start");
+
+    shutdownPool(ShutdownMode::Drain, "Drain         ");
+    shutdownPool(ShutdownMode::DiscardPending, "DiscardPending");
+    shutdownPool(ShutdownMode::CancelRunning, "CancelRunning ");
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// logging from many threads: std::osyncstream versus asynchronous backend
+
+static void logFromThreads(bool async, std::size_t numThreads)
+{
+    constexpr std::size_t NumLines{ 10'000 };
+
+    std::ostringstream sink;
+
+    if (async) {
+        Logger::startAsync(LogOverflow::Block);
+    }
+
+    std::atomic<bool> go{ false };
+    std::atomic<long long> callerNanoseconds{};
+    std::vector<std::jthread> threads;
+
+    for (std::size_t i{}; i != numThreads; ++i)
+    {
+        threads.emplace_back([&, i] () {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+
+            auto begin{ std::chrono::steady_clock::now() };
+
+            for (std::size_t n{}; n != NumLines; ++n) {
+                Logger::log(sink, "thread ", i, ": line ", n, ", value ", 0.5 * static_cast<double>(n));
+            }
+
+            auto end{ std::chrono::steady_clock::now() };
+
+            callerNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+        });
+    }
+
+    auto begin{ std::chrono::steady_clock::now() };
+
+    go = true;
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (async) {
+        Logger::stopAsync();   // writes all pending records
+    }
+
+    auto end{ std::chrono::steady_clock::now() };
+
+    std::size_t lines{ static_cast<std::size_t>(std::count(sink.view().begin(), sink.view().end(), '\n')) };
+
+    Logger::log(std::cout, async ? "asynchronous:    " : "std::osyncstream:", " ", numThreads, " threads: ",
+        callerNanoseconds.load() / static_cast<long long>(numThreads * NumLines), " ns per log call, ",
+        lines, " lines written in ", std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count(), " ms");
+}
+
+void test_concurrency_thread_pool23()
+{
+    Logger::log(std::cout, "Start");
+
+    for (std::size_t numThreads : { 1, 4, 32 })
+    {
+        logFromThreads(false, numThreads);
+        logFromThreads(true, numThreads);
+    }
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// latency distributions: ScopedTimer recording into named histograms
+
+void test_concurrency_thread_pool24()
+{
+    Logger::log(std::cout, "Start");
+
+    constexpr std::size_t NumTasks{ 100'000 };
+
+    static LatencyHistogram& execution{ LatencyHistogram::get("pool task: execution") };
+    static LatencyHistogram& startDelay{ LatencyHistogram::get("pool task: submit to start") };
+
+    execution.reset();
+    startDelay.reset();
+
+    {
+        ScopedTimer total{};   // nested timers: each one has its own start time
+
+        ThreadPool pool{};
+
+        pool.start();
+
+        Logger::enableLogging(false);
+
+        std::vector<TaskFuture<std::uint64_t>> futures;
+        futures.reserve(NumTasks);
+
+        for (std::size_t n{}; n != NumTasks; ++n)
+        {
+            auto submitted{ std::chrono::steady_clock::now() };
+
+            futures.push_back(pool.submit([submitted, n] () {
+                startDelay.record(std::chrono::steady_clock::now() - submitted);
+
+                ScopedTimer timer{ execution };
+
+                std::uint64_t x{ n + 1 };
+                for (std::size_t round{}; round != 100 + (n % 7) * 100; ++round) {
+                    x ^= x << 13;
+                    x ^= x >> 7;
+                    x ^= x << 17;
+                }
+                return x;
+            }));
+        }
+
+        for (auto& future : futures) {
+            future.get();
+        }
+
+        pool.stop();
+
+        Logger::enableLogging(true);
+    }
+
+    Logger::log(std::cout, execution.toString());
+    Logger::log(std::cout, startDelay.toString());
+
+    Logger::log(std::cout, "Done.");
+}
+
+// ===========================================================================
+// timeline of the workers: Chrome trace events (chrome://tracing, https://ui.perfetto.dev)
+
+void test_concurrency_thread_pool25()
+{
+    Logger::log(std::cout, "Start");
+
+    Tracing::enable(true);
+
+    {
+        ThreadPool pool{};
+
+        pool.start();
+
+        Logger::enableLogging(false);
+
+        std::vector<TaskFuture<std::size_t>> futures;
+
+        // tasks of different sizes: the imbalance shows up on the timeline
+        for (std::size_t n{}; n != 200; ++n)
+        {
+            futures.push_back(pool.submit([n] () {
+                TraceScope scope{ "prime search" };
+
+                std::size_t count{};
+                std::size_t from{ 1'000'000 + n * 1'000 };
+                for (std::size_t number{ from }; number != from + 100 * (1 + n % 10); ++number) {
+                    if (PrimeNumbers::IsPrime(number)) {
+                        ++count;
+                    }
+                }
+                return count;
+            }));
+        }
+
+        for (auto& future : futures) {
+            future.get();
+        }
+
+        pool.stop();
+
+        Logger::enableLogging(true);
+    }
+
+    Tracing::enable(false);
+
+    if (Tracing::dumpToFile("thread_pool_trace.json")) {
+        Logger::log(std::cout, "Trace written to thread_pool_trace.json");
+    }
+
+    Tracing::clear();
+
+    Logger::log(std::cout, "Done.");
+}
+
 // ===========================================================================
 // Primzahlenberechnung
 
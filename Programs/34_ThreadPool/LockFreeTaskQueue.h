@@ -0,0 +1,175 @@
+// ===========================================================================
+// LockFreeTaskQueue.h // Lock-free injection queue of the Thread Pool
+// ===========================================================================
+
+#pragma once
+
+#include "Task.h"
+#include "TaskQueue.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+
+// Bounded multi-producer/multi-consumer ring buffer (Dmitry Vyukov):
+// every cell carries a sequence number, which tells producers and consumers
+// whether the cell is ready to be written or to be read.
+// Producers and consumers only contend on their own position counter (one CAS per operation).
+// Same interface as TaskQueue: if the ring is full, tasks are put into a mutex protected
+// overflow queue, so push never fails - the FIFO order is relaxed in this (rare) case.
+
+template <std::size_t Capacity = 16384>
+class LockFreeTaskQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t>  m_sequence;
+        Task*                     m_task;
+    };
+
+    static constexpr std::size_t CacheLineSize{ std::hardware_destructive_interference_size };
+    static constexpr std::size_t Mask{ Capacity - 1 };
+
+    std::unique_ptr<Cell[]>                            m_cells;
+    alignas(CacheLineSize) std::atomic<std::size_t>    m_enqueuePos;
+    alignas(CacheLineSize) std::atomic<std::size_t>    m_dequeuePos;
+    alignas(CacheLineSize) std::atomic<std::size_t>    m_overflowCount;
+    TaskQueue                                          m_overflow;
+
+public:
+    // c'tor/d'tor
+    LockFreeTaskQueue()
+        : m_cells{ new Cell[Capacity] }, m_enqueuePos{}, m_dequeuePos{}, m_overflowCount{}
+    {
+        for (std::size_t i{}; i != Capacity; ++i) {
+            m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+            m_cells[i].m_task = nullptr;
+        }
+    }
+
+    ~LockFreeTaskQueue()
+    {
+        // tasks never executed: destroying them breaks their promises
+        while (Task* task{ tryPop() }) {
+            delete task;
+        }
+    }
+
+    // no copying or moving
+    LockFreeTaskQueue(const LockFreeTaskQueue&) = delete;
+    LockFreeTaskQueue& operator=(const LockFreeTaskQueue&) = delete;
+    LockFreeTaskQueue(LockFreeTaskQueue&&) = delete;
+    LockFreeTaskQueue& operator=(LockFreeTaskQueue&&) = delete;
+
+    // public interface
+    void push(Task* task)
+    {
+        if (!tryPush(task)) {
+            m_overflowCount.fetch_add(1);
+            m_overflow.push(task);
+        }
+    }
+
+    void push(std::span<Task* const> tasks)
+    {
+        for (Task* task : tasks) {
+            push(task);
+        }
+    }
+
+    // returns nullptr, if the queue is empty
+    Task* pop()
+    {
+        if (Task* task{ tryPop() }) {
+            return task;
+        }
+
+        if (m_overflowCount.load(std::memory_order_relaxed) != 0) {
+            if (Task* task{ m_overflow.pop() }) {
+                m_overflowCount.fetch_sub(1);
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // getter (approximate while other threads are active)
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    std::size_t size() const
+    {
+        std::size_t enqueuePos{ m_enqueuePos.load(std::memory_order_relaxed) };
+        std::size_t dequeuePos{ m_dequeuePos.load(std::memory_order_relaxed) };
+        std::size_t size{ enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0 };
+        return size + m_overflowCount.load(std::memory_order_relaxed);
+    }
+
+    // ring buffer only - returns false, if the ring is full
+    bool tryPush(Task* task)
+    {
+        std::size_t pos{ m_enqueuePos.load(std::memory_order_relaxed) };
+
+        while (true)
+        {
+            Cell& cell{ m_cells[pos & Mask] };
+            std::size_t sequence{ cell.m_sequence.load(std::memory_order_acquire) };
+            std::ptrdiff_t diff{ static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos) };
+
+            if (diff == 0) {
+                // cell is free: claim it
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.m_task = task;
+                    cell.m_sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;   // full
+            }
+            else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // ring buffer only - returns nullptr, if the ring is empty
+    Task* tryPop()
+    {
+        std::size_t pos{ m_dequeuePos.load(std::memory_order_relaxed) };
+
+        while (true)
+        {
+            Cell& cell{ m_cells[pos & Mask] };
+            std::size_t sequence{ cell.m_sequence.load(std::memory_order_acquire) };
+            std::ptrdiff_t diff{ static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1) };
+
+            if (diff == 0) {
+                // cell is filled: claim it
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    Task* task{ cell.m_task };
+                    cell.m_sequence.store(pos + Capacity, std::memory_order_release);
+                    return task;
+                }
+            }
+            else if (diff < 0) {
+                return nullptr;   // empty
+            }
+            else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
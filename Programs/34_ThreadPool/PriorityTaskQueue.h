@@ -0,0 +1,232 @@
+// ===========================================================================
+// PriorityTaskQueue.h // Priority lanes of the Thread Pool
+// ===========================================================================
+
+#pragma once
+
+#include "Task.h"
+#include "TaskQueue.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <span>
+#include <vector>
+
+enum class TaskPriority { High, Normal, Background };
+
+// One FIFO lane per priority class, higher lanes are drained first.
+// Aging: each time a task is taken from a higher lane while a lower lane is not empty,
+// the lower lane is "passed over". After 'AgingLimit' pass-overs the lower lane gets the next turn,
+// so background work cannot starve.
+// Deadlines: tasks with a deadline are kept in a heap (earliest deadline first) per lane.
+// They are dispatched ahead of the FIFO tasks of their lane, and before all other tasks
+// as soon as their deadline has been reached.
+// TLaneQueue: queue of a single lane, the mutex protected TaskQueue by default,
+// or a lock-free ring buffer (LockFreeTaskQueue).
+
+template <typename TLaneQueue = TaskQueue>
+class PriorityTaskQueue
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t   NumLanes{ 3 };
+    static constexpr std::uint32_t AgingLimit{ 16 };
+
+private:
+    struct DeadlineEntry
+    {
+        Clock::time_point  m_deadline;
+        std::uint64_t      m_sequence;    // FIFO order for equal deadlines
+        Task*              m_task;
+
+        bool operator> (const DeadlineEntry& other) const
+        {
+            return m_deadline != other.m_deadline
+                ? m_deadline > other.m_deadline
+                : m_sequence > other.m_sequence;
+        }
+    };
+
+    using DeadlineHeap = std::priority_queue<DeadlineEntry, std::vector<DeadlineEntry>, std::greater<DeadlineEntry>>;
+
+    std::array<TLaneQueue, NumLanes>                  m_lanes;
+    std::array<std::atomic<std::size_t>, NumLanes>    m_sizes;       // FIFO and deadline tasks per lane
+    std::array<std::atomic<std::uint32_t>, NumLanes>  m_passedOver;  // aging counters
+
+    mutable std::mutex                                m_mutexDeadlines;
+    std::array<DeadlineHeap, NumLanes>                m_deadlines;
+    std::atomic<std::size_t>                          m_numDeadlines;
+    std::uint64_t                                     m_sequence;
+
+public:
+    // c'tor/d'tor
+    PriorityTaskQueue() : m_sizes{}, m_passedOver{}, m_numDeadlines{}, m_sequence{} {}
+
+    ~PriorityTaskQueue()
+    {
+        // tasks never executed: destroying them breaks their promises
+        for (auto& heap : m_deadlines) {
+            while (!heap.empty()) {
+                delete heap.top().m_task;
+                heap.pop();
+            }
+        }
+    }
+
+    // no copying or moving
+    PriorityTaskQueue(const PriorityTaskQueue&) = delete;
+    PriorityTaskQueue& operator=(const PriorityTaskQueue&) = delete;
+    PriorityTaskQueue(PriorityTaskQueue&&) = delete;
+    PriorityTaskQueue& operator=(PriorityTaskQueue&&) = delete;
+
+    // public interface
+    void push(Task* task, TaskPriority priority = TaskPriority::Normal)
+    {
+        std::size_t lane{ static_cast<std::size_t>(priority) };
+        m_sizes[lane]++;
+        m_lanes[lane].push(task);
+    }
+
+    void push(std::span<Task* const> tasks, TaskPriority priority = TaskPriority::Normal)
+    {
+        std::size_t lane{ static_cast<std::size_t>(priority) };
+        m_sizes[lane] += tasks.size();
+        m_lanes[lane].push(tasks);
+    }
+
+    void push(Task* task, TaskPriority priority, Clock::time_point deadline)
+    {
+        std::size_t lane{ static_cast<std::size_t>(priority) };
+        m_sizes[lane]++;
+
+        std::lock_guard<std::mutex> guard{ m_mutexDeadlines };
+        m_deadlines[lane].push(DeadlineEntry{ deadline, m_sequence++, task });
+        m_numDeadlines++;
+    }
+
+    // tasks that must not wait: overdue deadlines, aged lanes and the high priority lane
+    Task* popUrgent()
+    {
+        if (m_numDeadlines != 0) {
+            if (Task* task{ popDeadline(0, NumLanes - 1, Clock::now()) }) {
+                return task;
+            }
+        }
+
+        // a lane that has been passed over too often gets a turn
+        for (std::size_t lane{ NumLanes - 1 }; lane != 0; --lane)
+        {
+            if (m_passedOver[lane] >= AgingLimit) {
+                m_passedOver[lane] = 0;
+                if (Task* task{ popLane(lane) }) {
+                    return task;
+                }
+            }
+        }
+
+        return popLane(static_cast<std::size_t>(TaskPriority::High));
+    }
+
+    // any task, honoring priorities and aging - returns nullptr, if all lanes are empty
+    Task* pop()
+    {
+        if (Task* task{ popUrgent() }) {
+            return task;
+        }
+
+        for (std::size_t lane{ 1 }; lane != NumLanes; ++lane)
+        {
+            if (Task* task{ popLane(lane) }) {
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    std::size_t size() const
+    {
+        std::size_t size{};
+        for (const auto& laneSize : m_sizes) {
+            size += laneSize;
+        }
+        return size;
+    }
+
+private:
+    Task* popLane(std::size_t lane)
+    {
+        if (m_sizes[lane] == 0) {
+            return nullptr;
+        }
+
+        Task* task{ nullptr };
+
+        // a pending deadline task doesn't wait behind the FIFO backlog of its lane
+        if (m_numDeadlines != 0) {
+            task = popDeadline(lane, lane, Clock::time_point::max());
+        }
+
+        if (task == nullptr) {
+            task = m_lanes[lane].pop();
+
+            if (task != nullptr) {
+                m_sizes[lane]--;
+            }
+        }
+
+        if (task == nullptr) {
+            return nullptr;
+        }
+
+        // aging: lower lanes waiting while this one was served
+        for (std::size_t lower{ lane + 1 }; lower < NumLanes; ++lower) {
+            if (m_sizes[lower] != 0) {
+                m_passedOver[lower]++;
+            }
+        }
+
+        return task;
+    }
+
+    // earliest deadline task of the lanes [firstLane, lastLane], if it is due by 'dueBy'
+    Task* popDeadline(std::size_t firstLane, std::size_t lastLane, Clock::time_point dueBy)
+    {
+        std::lock_guard<std::mutex> guard{ m_mutexDeadlines };
+
+        std::size_t lane{ NumLanes };
+
+        for (std::size_t i{ firstLane }; i <= lastLane; ++i) {
+            if (!m_deadlines[i].empty() && (lane == NumLanes ||
+                m_deadlines[i].top().m_deadline < m_deadlines[lane].top().m_deadline)) {
+                lane = i;
+            }
+        }
+
+        if (lane == NumLanes || m_deadlines[lane].top().m_deadline > dueBy) {
+            return nullptr;
+        }
+
+        Task* task{ m_deadlines[lane].top().m_task };
+        m_deadlines[lane].pop();
+        m_numDeadlines--;
+        m_sizes[lane]--;
+        return task;
+    }
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
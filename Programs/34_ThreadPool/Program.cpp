@@ -4,10 +4,27 @@
 
 extern void test_concurrency_thread_pool01();    // just launching ... and stopping the thread pool
 extern void test_concurrency_thread_pool02();    // launching 5 almost empty tasks
+extern void test_concurrency_thread_pool07();    // benchmark: allocations per task and tasks per second (addTask vs. submit)
 
 extern void test_concurrency_thread_pool03();    // launching many tasks ... and working on the same global variable (by address)
 extern void test_concurrency_thread_pool04();    // launching many tasks ... and working on an atomic variable (by address)
 extern void test_concurrency_thread_pool05();    // launching many tasks ... and working on an atomic variable (by reference)
+extern void test_concurrency_thread_pool06();    // tasks launching tasks ... work stealing between the workers
+extern void test_concurrency_thread_pool08();    // bulk submission of tasks ... one lock and one wakeup per batch
+extern void test_concurrency_thread_pool09();    // nested parallelism ... tasks waiting for other tasks (helping wait)
+extern void test_concurrency_thread_pool13();    // benchmark: latency of high priority tasks in a saturated pool
+extern void test_concurrency_thread_pool14();    // configured start: number of workers, CPU affinity and thread names
+extern void test_concurrency_thread_pool15();    // elastic mode: growing with blocking tasks, shrinking when idle
+extern void test_concurrency_thread_pool16();    // benchmark: enqueue/dequeue latencies, mutex vs. lock-free injection queue
+extern void test_concurrency_thread_pool17();    // continuations: then, whenAll and whenAny - no thread blocks per stage
+extern void test_concurrency_thread_pool18();    // task graph: built once, run repeatedly - compared to level by level barriers
+extern void test_concurrency_thread_pool19();    // coroutines: co_await pool.schedule(), awaiting CoTask and TaskFuture objects
+extern void test_concurrency_thread_pool20();    // delayed and periodic tasks - benchmark: 1.000.000 pending timers
+extern void test_concurrency_thread_pool21();    // runtime statistics: per worker counters and queue wait times
+extern void test_concurrency_thread_pool22();    // shutdown modes: drain, discard pending tasks, cancel running tasks
+extern void test_concurrency_thread_pool23();    // logging from many threads: std::osyncstream versus asynchronous backend
+extern void test_concurrency_thread_pool24();    // latency distributions: ScopedTimer recording into named histograms
+extern void test_concurrency_thread_pool25();    // timeline of the workers: Chrome trace events
 
 extern void test_concurrency_thread_pool10();    // computing prime numbers, using free function (minimum variant)
 extern void test_concurrency_thread_pool11();    // computing prime numbers, using lambda (printing values to the console) 
@@ -17,10 +34,27 @@ int main()
 {
     test_concurrency_thread_pool01();            // just launching ... and stopping the thread pool
     test_concurrency_thread_pool02();            // launching 5 almost empty tasks
+    test_concurrency_thread_pool07();            // benchmark: allocations per task and tasks per second (addTask vs. submit)
 
     test_concurrency_thread_pool03();            // launching many tasks ... and working on the same global variable (by address)
     test_concurrency_thread_pool04();            // launching many tasks ... and working on an atomic variable (by address)
     test_concurrency_thread_pool05();            // launching many tasks ... and working on an atomic variable (by reference)
+    test_concurrency_thread_pool06();            // tasks launching tasks ... work stealing between the workers
+    test_concurrency_thread_pool08();            // bulk submission of tasks ... one lock and one wakeup per batch
+    test_concurrency_thread_pool09();            // nested parallelism ... tasks waiting for other tasks (helping wait)
+    test_concurrency_thread_pool13();            // benchmark: latency of high priority tasks in a saturated pool
+    test_concurrency_thread_pool14();            // configured start: number of workers, CPU affinity and thread names
+    test_concurrency_thread_pool15();            // elastic mode: growing with blocking tasks, shrinking when idle
+    test_concurrency_thread_pool16();            // benchmark: enqueue/dequeue latencies, mutex vs. lock-free injection queue
+    test_concurrency_thread_pool17();            // continuations: then, whenAll and whenAny - no thread blocks per stage
+    test_concurrency_thread_pool18();            // task graph: built once, run repeatedly - compared to level by level barriers
+    test_concurrency_thread_pool19();            // coroutines: co_await pool.schedule(), awaiting CoTask and TaskFuture objects
+    test_concurrency_thread_pool20();            // delayed and periodic tasks - benchmark: 1.000.000 pending timers
+    test_concurrency_thread_pool21();            // runtime statistics: per worker counters and queue wait times
+    test_concurrency_thread_pool22();            // shutdown modes: drain, discard pending tasks, cancel running tasks
+    test_concurrency_thread_pool23();            // logging from many threads: std::osyncstream versus asynchronous backend
+    test_concurrency_thread_pool24();            // latency distributions: ScopedTimer recording into named histograms
+    test_concurrency_thread_pool25();            // timeline of the workers: Chrome trace events
 
     test_concurrency_thread_pool10();            // computing prime numbers (minimum variant)
     test_concurrency_thread_pool11();            // computing prime numbers (printing values to the console) 
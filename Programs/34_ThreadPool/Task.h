@@ -0,0 +1,159 @@
+// ===========================================================================
+// Task.h // Move-only callable with inline storage
+// ===========================================================================
+
+#pragma once
+
+#include "../Globals/MemoryPool.h"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Similar to std::move_only_function<void()>, but callables up to 'InlineSize' bytes
+// are always stored inside the object (no heap allocation).
+// Task objects themselves are allocated from a BlockPool.
+
+class Task
+{
+public:
+    static constexpr std::size_t InlineSize{ 64 };
+
+private:
+    struct VTable
+    {
+        void (*m_invoke)  (void* storage);
+        void (*m_move)    (void* target, void* source);   // move constructs target, destroys source
+        void (*m_destroy) (void* storage);
+    };
+
+    template <typename TFunc>
+    static constexpr bool IsInline {
+        sizeof(TFunc) <= InlineSize &&
+        alignof(TFunc) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<TFunc>
+    };
+
+    template <typename TFunc>
+    static constexpr VTable InlineVTable {
+        [] (void* storage) { std::invoke(*static_cast<TFunc*>(storage)); },
+        [] (void* target, void* source) {
+            ::new (target) TFunc{ std::move(*static_cast<TFunc*>(source)) };
+            static_cast<TFunc*>(source)->~TFunc();
+        },
+        [] (void* storage) { static_cast<TFunc*>(storage)->~TFunc(); }
+    };
+
+    // fallback for large callables: storage holds a pointer to the callable
+    template <typename TFunc>
+    static constexpr VTable HeapVTable {
+        [] (void* storage) { std::invoke(**static_cast<TFunc**>(storage)); },
+        [] (void* target, void* source) {
+            ::new (target) TFunc* { *static_cast<TFunc**>(source) };
+        },
+        [] (void* storage) { delete *static_cast<TFunc**>(storage); }
+    };
+
+    alignas(std::max_align_t) std::byte m_storage[InlineSize];
+    const VTable* m_vtable;
+    std::uint64_t m_enqueued;   // time stamp, set by the thread pool (statistics) - fits into the padding
+
+public:
+    // c'tors/d'tor
+    Task() : m_storage{}, m_vtable{ nullptr }, m_enqueued{} {}
+
+    template <typename TFunc>
+        requires (!std::same_as<std::remove_cvref_t<TFunc>, Task> && std::invocable<std::decay_t<TFunc>&>)
+    Task(TFunc&& func) : m_storage{}, m_enqueued{}
+    {
+        using Callable = std::decay_t<TFunc>;
+
+        if constexpr (IsInline<Callable>) {
+            ::new (static_cast<void*>(m_storage)) Callable{ std::forward<TFunc>(func) };
+            m_vtable = &InlineVTable<Callable>;
+        }
+        else {
+            ::new (static_cast<void*>(m_storage)) Callable* { new Callable{ std::forward<TFunc>(func) } };
+            m_vtable = &HeapVTable<Callable>;
+        }
+    }
+
+    ~Task()
+    {
+        reset();
+    }
+
+    // move semantics only
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    Task(Task&& other) noexcept : m_storage{}, m_vtable{ other.m_vtable }, m_enqueued{ other.m_enqueued }
+    {
+        if (m_vtable != nullptr) {
+            m_vtable->m_move(m_storage, other.m_storage);
+            other.m_vtable = nullptr;
+        }
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (&other != this) {
+            reset();
+            m_vtable = other.m_vtable;
+            m_enqueued = other.m_enqueued;
+            if (m_vtable != nullptr) {
+                m_vtable->m_move(m_storage, other.m_storage);
+                other.m_vtable = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    // public interface
+    void operator()()
+    {
+        m_vtable->m_invoke(m_storage);
+    }
+
+    explicit operator bool() const
+    {
+        return m_vtable != nullptr;
+    }
+
+    void setEnqueued(std::uint64_t timestamp)
+    {
+        m_enqueued = timestamp;
+    }
+
+    std::uint64_t enqueued() const
+    {
+        return m_enqueued;
+    }
+
+    void reset()
+    {
+        if (m_vtable != nullptr) {
+            m_vtable->m_destroy(m_storage);
+            m_vtable = nullptr;
+        }
+    }
+
+    // Task objects are recycled
+    static void* operator new(std::size_t)
+    {
+        return BlockPool<sizeof(Task)>::allocate();
+    }
+
+    static void operator delete(void* ptr)
+    {
+        BlockPool<sizeof(Task)>::deallocate(ptr);
+    }
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -0,0 +1,464 @@
+// ===========================================================================
+// TaskFuture.h // Promise/Future pair with recycled shared state
+// ===========================================================================
+
+#pragma once
+
+#include "../Globals/MemoryPool.h"
+
+#include "Task.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Lightweight counterpart of std::promise / std::future:
+// the shared state is allocated from a BlockPool and recycled,
+// waiting is realized with std::atomic::wait instead of a mutex/condition variable.
+// Continuations: a task attached to the shared state is scheduled on the thread pool
+// as soon as the result is available - no thread blocks to forward a result.
+
+class ThreadPool;
+
+namespace ThreadPoolDetail
+{
+    struct VoidResult {};
+
+    // schedules a continuation on the given pool - or runs it immediately, if there is no pool
+    // (defined in ThreadPool.cpp)
+    void dispatchContinuation(ThreadPool* pool, Task* continuation);
+
+    template <typename T>
+    using ResultType = std::conditional_t<std::is_void_v<T>, VoidResult, T>;
+
+    template <typename T>
+    class TaskState
+    {
+    private:
+        // values of m_ready
+        static constexpr std::uint32_t Pending{ 0 };
+        static constexpr std::uint32_t Ready{ 1 };
+        static constexpr std::uint32_t Attached{ 2 };   // pending, continuation attached
+
+        std::atomic<std::uint32_t>                                   m_ready;
+        std::atomic<std::uint32_t>                                   m_references;
+        std::variant<std::monostate, ResultType<T>, std::exception_ptr> m_result;
+        ThreadPool*                                                  m_pool;           // runs the continuation
+        Task*                                                        m_continuation;
+
+    public:
+        explicit TaskState(ThreadPool* pool = nullptr)
+            : m_ready{ Pending }, m_references{ 2 }, m_result{}, m_pool{ pool }, m_continuation{ nullptr }   // promise + future
+        {}
+
+        ThreadPool* pool() const { return m_pool; }
+
+        template <typename... TArgs>
+        void setValue(TArgs&&... args)
+        {
+            m_result.template emplace<1>(std::forward<TArgs>(args)...);
+            complete();
+        }
+
+        void setException(std::exception_ptr exception)
+        {
+            m_result.template emplace<2>(std::move(exception));
+            complete();
+        }
+
+        // at most one continuation per state
+        void setContinuation(Task* continuation)
+        {
+            m_continuation = continuation;
+
+            std::uint32_t expected{ Pending };
+            if (!m_ready.compare_exchange_strong(expected, Attached, std::memory_order_acq_rel)) {
+                // result is already available
+                m_continuation = nullptr;
+                dispatchContinuation(m_pool, continuation);
+            }
+        }
+
+        bool isReady() const
+        {
+            return m_ready.load(std::memory_order_acquire) == Ready;
+        }
+
+        void wait() const
+        {
+            std::uint32_t ready{ m_ready.load(std::memory_order_acquire) };
+
+            while (ready != Ready) {
+                m_ready.wait(ready, std::memory_order_acquire);
+                ready = m_ready.load(std::memory_order_acquire);
+            }
+        }
+
+        ResultType<T> get()
+        {
+            wait();
+
+            if (m_result.index() == 2) {
+                std::rethrow_exception(std::get<2>(m_result));
+            }
+
+            return std::move(std::get<1>(m_result));
+        }
+
+        void release()
+        {
+            if (m_references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                delete this;
+            }
+        }
+
+        // shared states are recycled
+        static void* operator new(std::size_t)
+        {
+            return BlockPool<sizeof(TaskState)>::allocate();
+        }
+
+        static void operator delete(void* ptr)
+        {
+            BlockPool<sizeof(TaskState)>::deallocate(ptr);
+        }
+
+    private:
+        void complete()
+        {
+            std::uint32_t previous{ m_ready.exchange(Ready, std::memory_order_acq_rel) };
+            m_ready.notify_all();
+
+            if (previous == Attached) {
+                dispatchContinuation(m_pool, std::exchange(m_continuation, nullptr));
+            }
+        }
+    };
+
+    template <typename T, typename TFunc>
+    struct ContinuationResult
+    {
+        using type = std::invoke_result_t<TFunc, T>;
+    };
+
+    template <typename TFunc>
+    struct ContinuationResult<void, TFunc>
+    {
+        using type = std::invoke_result_t<TFunc>;
+    };
+}
+
+template <typename T>
+class TaskPromise;
+
+template <typename T>
+class TaskFuture
+{
+private:
+    ThreadPoolDetail::TaskState<T>* m_state;
+
+public:
+    // c'tors/d'tor
+    TaskFuture() : m_state{ nullptr } {}
+
+    explicit TaskFuture(ThreadPoolDetail::TaskState<T>* state) : m_state{ state } {}
+
+    ~TaskFuture()
+    {
+        if (m_state != nullptr) {
+            m_state->release();
+        }
+    }
+
+    // move semantics only
+    TaskFuture(const TaskFuture&) = delete;
+    TaskFuture& operator=(const TaskFuture&) = delete;
+
+    TaskFuture(TaskFuture&& other) noexcept : m_state{ std::exchange(other.m_state, nullptr) } {}
+
+    TaskFuture& operator=(TaskFuture&& other) noexcept
+    {
+        if (&other != this) {
+            if (m_state != nullptr) {
+                m_state->release();
+            }
+            m_state = std::exchange(other.m_state, nullptr);
+        }
+        return *this;
+    }
+
+    // public interface
+    bool valid() const { return m_state != nullptr; }
+
+    bool isReady() const { return m_state->isReady(); }
+
+    void wait() const { m_state->wait(); }
+
+    // schedules 'func' on the pool, once the result of this future is available:
+    // 'func' receives the result (no parameter for TaskFuture<void>),
+    // an exception is forwarded to the returned future without calling 'func'.
+    // The future is consumed (like get), no thread blocks.
+    template <typename TFunc>
+    auto then(TFunc&& func) -> TaskFuture<typename ThreadPoolDetail::ContinuationResult<T, TFunc>::type>
+    {
+        using ReturnType = ThreadPoolDetail::ContinuationResult<T, TFunc>::type;
+
+        ThreadPoolDetail::TaskState<T>* state{ m_state };
+
+        TaskPromise<ReturnType> promise{ state->pool() };
+
+        auto future{ promise.getFuture() };
+
+        Task* continuation{ new Task{
+            [antecedent = std::move(*this),
+            promise = std::move(promise),
+            func = std::forward<TFunc>(func)] () mutable -> void
+            {
+                try
+                {
+                    if constexpr (std::is_void_v<T>) {
+                        antecedent.get();
+                        promise.setFromInvoke(std::move(func));
+                    }
+                    else {
+                        promise.setFromInvoke(std::move(func), antecedent.get());
+                    }
+                }
+                catch (...)
+                {
+                    promise.setException(std::current_exception());   // exception of the antecedent
+                }
+            }
+        } };
+
+        state->setContinuation(continuation);
+
+        return future;
+    }
+
+    // low level: attaches a continuation, which does not consume this future
+    void onReady(Task* continuation)
+    {
+        m_state->setContinuation(continuation);
+    }
+
+    ThreadPool* pool() const { return m_state->pool(); }
+
+    // like std::future::get: may be called only once
+    T get()
+    {
+        ThreadPoolDetail::TaskState<T>* state{ std::exchange(m_state, nullptr) };
+
+        struct Release {
+            ThreadPoolDetail::TaskState<T>* m_state;
+            ~Release() { m_state->release(); }
+        } release{ state };
+
+        if constexpr (std::is_void_v<T>) {
+            state->get();
+        }
+        else {
+            return state->get();
+        }
+    }
+};
+
+template <typename T>
+class TaskPromise
+{
+private:
+    ThreadPoolDetail::TaskState<T>* m_state;
+    bool                            m_satisfied;
+    bool                            m_retrieved;
+
+public:
+    // c'tors/d'tor
+    // continuations of the future are scheduled on 'pool'
+    explicit TaskPromise(ThreadPool* pool = nullptr)
+        : m_state{ new ThreadPoolDetail::TaskState<T>{ pool } }, m_satisfied{ false }, m_retrieved{ false }
+    {}
+
+    ~TaskPromise()
+    {
+        if (m_state == nullptr) {
+            return;
+        }
+
+        if (!m_satisfied) {
+            m_state->setException(
+                std::make_exception_ptr(std::future_error{ std::future_errc::broken_promise })
+            );
+        }
+
+        if (!m_retrieved) {
+            m_state->release();   // reference of the (never created) future
+        }
+
+        m_state->release();
+    }
+
+    // move semantics only
+    TaskPromise(const TaskPromise&) = delete;
+    TaskPromise& operator=(const TaskPromise&) = delete;
+
+    TaskPromise(TaskPromise&& other) noexcept
+        : m_state{ std::exchange(other.m_state, nullptr) },
+          m_satisfied{ other.m_satisfied },
+          m_retrieved{ other.m_retrieved }
+    {}
+
+    TaskPromise& operator=(TaskPromise&&) = delete;
+
+    // public interface
+    TaskFuture<T> getFuture()
+    {
+        m_retrieved = true;
+        return TaskFuture<T>{ m_state };
+    }
+
+    template <typename... TArgs>
+    void setValue(TArgs&&... args)
+    {
+        m_satisfied = true;
+        m_state->setValue(std::forward<TArgs>(args)...);
+    }
+
+    void setException(std::exception_ptr exception)
+    {
+        m_satisfied = true;
+        m_state->setException(std::move(exception));
+    }
+
+    // invokes the callable and stores either its result or the thrown exception
+    template <typename TFunc, typename... TArgs>
+    void setFromInvoke(TFunc&& func, TArgs&&... args)
+    {
+        try
+        {
+            if constexpr (std::is_void_v<T>) {
+                std::invoke(std::forward<TFunc>(func), std::forward<TArgs>(args)...);
+                setValue();
+            }
+            else {
+                setValue(std::invoke(std::forward<TFunc>(func), std::forward<TArgs>(args)...));
+            }
+        }
+        catch (...)
+        {
+            setException(std::current_exception());
+        }
+    }
+};
+
+// ===========================================================================
+
+template <typename T>
+struct WhenAnyResult
+{
+    std::size_t                  m_index;     // first future that became ready
+    std::vector<TaskFuture<T>>   m_futures;
+};
+
+// the returned future becomes ready, when all given futures are ready,
+// it contains the (ready) futures, so that every result/exception can be retrieved
+template <typename T>
+TaskFuture<std::vector<TaskFuture<T>>> whenAll(std::vector<TaskFuture<T>> futures)
+{
+    struct Context
+    {
+        std::vector<TaskFuture<T>>                 m_futures;
+        std::atomic<std::size_t>                   m_remaining;
+        TaskPromise<std::vector<TaskFuture<T>>>    m_promise;
+
+        void release()
+        {
+            if (m_remaining.fetch_sub(1) == 1) {
+                m_promise.setValue(std::move(m_futures));
+            }
+        }
+    };
+
+    ThreadPool* pool{ futures.empty() ? nullptr : futures.front().pool() };
+
+    std::size_t count{ futures.size() };
+
+    // one additional count for the registration loop: m_futures must not be moved away while iterating
+    auto context{ std::make_shared<Context>(std::move(futures), count + 1, TaskPromise<std::vector<TaskFuture<T>>>{ pool }) };
+
+    auto future{ context->m_promise.getFuture() };
+
+    for (std::size_t index{}; index != count; ++index)
+    {
+        context->m_futures[index].onReady(new Task{ [context] () -> void { context->release(); } });
+    }
+
+    context->release();
+
+    return future;
+}
+
+// the returned future becomes ready, when the first of the given futures is ready
+template <typename T>
+TaskFuture<WhenAnyResult<T>> whenAny(std::vector<TaskFuture<T>> futures)
+{
+    static constexpr std::size_t NoIndex{ static_cast<std::size_t>(-1) };
+
+    struct Context
+    {
+        std::vector<TaskFuture<T>>          m_futures;
+        std::atomic<std::size_t>            m_first;
+        std::atomic<std::size_t>            m_remaining;   // registration loop + first ready future
+        TaskPromise<WhenAnyResult<T>>       m_promise;
+
+        void release()
+        {
+            if (m_remaining.fetch_sub(1) == 1) {
+                m_promise.setValue(WhenAnyResult<T>{ m_first.load(), std::move(m_futures) });
+            }
+        }
+    };
+
+    ThreadPool* pool{ futures.empty() ? nullptr : futures.front().pool() };
+
+    std::size_t count{ futures.size() };
+
+    auto context{ std::make_shared<Context>(std::move(futures), NoIndex, 2, TaskPromise<WhenAnyResult<T>>{ pool }) };
+
+    auto future{ context->m_promise.getFuture() };
+
+    if (count == 0) {
+        context->m_promise.setException(
+            std::make_exception_ptr(std::future_error{ std::future_errc::no_state })
+        );
+        return future;
+    }
+
+    for (std::size_t index{}; index != count; ++index)
+    {
+        context->m_futures[index].onReady(new Task{
+            [context, index] () -> void
+            {
+                std::size_t expected{ NoIndex };
+                if (context->m_first.compare_exchange_strong(expected, index)) {
+                    context->release();
+                }
+            }
+        });
+    }
+
+    context->release();
+
+    return future;
+}
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -0,0 +1,266 @@
+// ===========================================================================
+// TaskGraph.cpp // Task graph (DAG) executor on top of the Thread Pool
+// ===========================================================================
+
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <array>
+#include <future>
+#include <span>
+#include <stdexcept>
+
+TaskGraph::TaskGraph(GraphOrdering ordering)
+    : m_ordering{ ordering }, m_prepared{ false }, m_pool{ nullptr },
+      m_remaining{}, m_running{ false }, m_failed{ false }
+{}
+
+void TaskGraph::addEdge(NodeId from, NodeId to)
+{
+    if (from >= m_nodes.size() || to >= m_nodes.size()) {
+        throw std::out_of_range{ "TaskGraph: unknown node" };
+    }
+
+    m_prepared = false;
+    m_nodes[from].m_successors.push_back(to);
+    m_nodes[to].m_predecessors++;
+}
+
+TaskFuture<void> TaskGraph::run(ThreadPool& pool)
+{
+    if (m_running.exchange(true)) {
+        throw std::logic_error{ "TaskGraph: graph is already running" };
+    }
+
+    if (!m_prepared) {
+        try
+        {
+            prepare();
+        }
+        catch (...)
+        {
+            m_running = false;
+            throw;
+        }
+    }
+
+    m_pool = &pool;
+    m_failed = false;
+    m_exception = nullptr;
+    m_promise.emplace(&pool);
+
+    auto future{ m_promise->getFuture() };
+
+    if (m_nodes.empty()) {
+        finish();
+        return future;
+    }
+
+    for (std::size_t i{}; i != m_nodes.size(); ++i) {
+        m_pending[i].store(m_nodes[i].m_predecessors, std::memory_order_relaxed);
+    }
+
+    m_remaining.store(m_nodes.size());
+
+    std::array<Task*, BatchSize> batch{};
+    std::size_t count{};
+
+    for (NodeId root : m_roots)
+    {
+        batch[count++] = new Task{ NodeTask{ this, root } };
+
+        if (count == BatchSize) {
+            m_pool->schedule(std::span<Task* const>{ batch.data(), count });
+            count = 0;
+        }
+    }
+
+    m_pool->schedule(std::span<Task* const>{ batch.data(), count });
+
+    return future;
+}
+
+std::size_t TaskGraph::size() const
+{
+    return m_nodes.size();
+}
+
+std::size_t TaskGraph::criticalPath() const
+{
+    std::size_t length{};
+
+    for (NodeId root : m_roots) {
+        length = std::max(length, m_nodes[root].m_criticalPath);
+    }
+
+    return length;
+}
+
+void TaskGraph::prepare()
+{
+    // topological order (Kahn's algorithm), detects cycles
+    std::vector<std::size_t> predecessors(m_nodes.size());
+    std::vector<NodeId> order;
+    order.reserve(m_nodes.size());
+
+    m_roots.clear();
+
+    for (NodeId id{}; id != m_nodes.size(); ++id)
+    {
+        predecessors[id] = m_nodes[id].m_predecessors;
+
+        if (predecessors[id] == 0) {
+            m_roots.push_back(id);
+            order.push_back(id);
+        }
+    }
+
+    for (std::size_t i{}; i != order.size(); ++i)
+    {
+        for (NodeId successor : m_nodes[order[i]].m_successors)
+        {
+            if (--predecessors[successor] == 0) {
+                order.push_back(successor);
+            }
+        }
+    }
+
+    if (order.size() != m_nodes.size()) {
+        throw std::logic_error{ "TaskGraph: graph contains a cycle" };
+    }
+
+    // critical path: longest path to a sink, computed in reverse topological order
+    for (auto it{ order.rbegin() }; it != order.rend(); ++it)
+    {
+        Node& node{ m_nodes[*it] };
+
+        std::size_t longest{};
+        for (NodeId successor : node.m_successors) {
+            longest = std::max(longest, m_nodes[successor].m_criticalPath);
+        }
+
+        node.m_criticalPath = node.m_cost + longest;
+    }
+
+    if (m_ordering == GraphOrdering::CriticalPathFirst)
+    {
+        auto longerPath = [this] (NodeId lhs, NodeId rhs) {
+            return m_nodes[lhs].m_criticalPath > m_nodes[rhs].m_criticalPath;
+        };
+
+        for (Node& node : m_nodes) {
+            std::stable_sort(node.m_successors.begin(), node.m_successors.end(), longerPath);
+        }
+
+        std::stable_sort(m_roots.begin(), m_roots.end(), longerPath);
+    }
+
+    m_pending = std::make_unique<std::atomic<std::size_t>[]>(m_nodes.size());
+
+    m_prepared = true;
+}
+
+void TaskGraph::runNode(NodeId id)
+{
+    while (id != NoNode)
+    {
+        Node& node{ m_nodes[id] };
+
+        if (!m_failed.load(std::memory_order_relaxed))
+        {
+            try
+            {
+                node.m_work();
+            }
+            catch (...)
+            {
+                fail(std::current_exception());
+            }
+        }
+
+        // release the successors: the first runnable one (in the order of m_successors) is continued
+        // in this thread, the others are scheduled in reverse order - a worker pops its own deque
+        // in LIFO order, so the more important ones are taken first
+        NodeId next{ NoNode };
+
+        std::array<Task*, BatchSize> batch{};
+        std::size_t count{};
+
+        for (auto it{ node.m_successors.rbegin() }; it != node.m_successors.rend(); ++it)
+        {
+            if (m_pending[*it].fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                continue;
+            }
+
+            if (next != NoNode)
+            {
+                batch[count++] = new Task{ NodeTask{ this, next } };
+
+                if (count == BatchSize) {
+                    m_pool->schedule(std::span<Task* const>{ batch.data(), count });
+                    count = 0;
+                }
+            }
+
+            next = *it;
+        }
+
+        m_pool->schedule(std::span<Task* const>{ batch.data(), count });
+
+        if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            finish();   // last node: 'next' is NoNode
+        }
+
+        id = next;
+    }
+}
+
+void TaskGraph::fail(std::exception_ptr exception)
+{
+    if (!m_failed.exchange(true)) {
+        m_exception = exception;
+    }
+}
+
+void TaskGraph::finish()
+{
+    // the graph may be run again as soon as the promise is satisfied
+    TaskPromise<void> promise{ std::move(*m_promise) };
+    m_promise.reset();
+
+    std::exception_ptr exception{ m_exception };
+
+    m_running = false;
+
+    if (exception) {
+        promise.setException(exception);
+    }
+    else {
+        promise.setValue();
+    }
+}
+
+TaskGraph::NodeTask::NodeTask(TaskGraph* graph, NodeId id)
+    : m_graph{ graph }, m_id{ id }
+{}
+
+TaskGraph::NodeTask::NodeTask(NodeTask&& other) noexcept
+    : m_graph{ std::exchange(other.m_graph, nullptr) }, m_id{ other.m_id }
+{}
+
+TaskGraph::NodeTask::~NodeTask()
+{
+    if (m_graph != nullptr) {
+        m_graph->fail(std::make_exception_ptr(std::future_error{ std::future_errc::broken_promise }));
+        m_graph->runNode(m_id);
+    }
+}
+
+void TaskGraph::NodeTask::operator()()
+{
+    std::exchange(m_graph, nullptr)->runNode(m_id);
+}
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -0,0 +1,120 @@
+// ===========================================================================
+// TaskGraph.h // Task graph (DAG) executor on top of the Thread Pool
+// ===========================================================================
+
+#pragma once
+
+#include "Task.h"
+#include "TaskFuture.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Nodes and edges are built once, the graph can then be run repeatedly.
+// Every node has an atomic counter of unfinished predecessors: the node becomes runnable
+// the moment its last predecessor finishes - there are no barriers between the "levels" of the graph.
+// A finishing node continues with one of its runnable successors in the same thread,
+// the other ones are scheduled on the pool.
+// Running a prepared graph doesn't allocate memory besides the (recycled) tasks of the pool.
+
+enum class GraphOrdering
+{
+    Insertion,          // successors are released in the order the edges have been added
+    CriticalPathFirst   // successors with the longest remaining path (sum of costs) are released first
+};
+
+class TaskGraph
+{
+public:
+    using NodeId = std::size_t;
+
+private:
+    using Work = std::move_only_function<void()>;
+
+    struct Node
+    {
+        Work                  m_work;
+        std::size_t           m_cost;           // estimate, used for the critical path
+        std::vector<NodeId>   m_successors;
+        std::size_t           m_predecessors;
+        std::size_t           m_criticalPath;   // longest path from this node to a sink, including its own cost
+    };
+
+    // runs a node - a task destroyed without having been run (ShutdownMode::DiscardPending)
+    // fails the run with a broken_promise error, the successors are released without being executed
+    struct NodeTask
+    {
+        TaskGraph*  m_graph;
+        NodeId      m_id;
+
+        NodeTask(TaskGraph* graph, NodeId id);
+        NodeTask(NodeTask&& other) noexcept;
+        ~NodeTask();
+
+        void operator()();
+    };
+
+    static constexpr NodeId      NoNode{ static_cast<NodeId>(-1) };
+    static constexpr std::size_t BatchSize{ 32 };   // successors scheduled at once
+
+    GraphOrdering                                  m_ordering;
+    std::vector<Node>                              m_nodes;
+    std::vector<NodeId>                            m_roots;
+    bool                                           m_prepared;
+
+    // state of the current run
+    ThreadPool*                                    m_pool;
+    std::unique_ptr<std::atomic<std::size_t>[]>    m_pending;      // unfinished predecessors per node
+    std::atomic<std::size_t>                       m_remaining;    // unfinished nodes
+    std::atomic<bool>                              m_running;
+    std::atomic<bool>                              m_failed;
+    std::exception_ptr                             m_exception;
+    std::optional<TaskPromise<void>>               m_promise;
+
+public:
+    // c'tors/d'tor
+    explicit TaskGraph(GraphOrdering ordering = GraphOrdering::Insertion);
+
+    // no copying or moving
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+    TaskGraph(TaskGraph&&) = delete;
+    TaskGraph& operator=(TaskGraph&&) = delete;
+
+    // building the graph - not allowed while the graph is running
+    template <typename TFunc>
+    NodeId addNode(TFunc&& work, std::size_t cost = 1)
+    {
+        m_prepared = false;
+        m_nodes.push_back(Node{ Work{ std::forward<TFunc>(work) }, cost, {}, 0, 0 });
+        return m_nodes.size() - 1;
+    }
+
+    // 'to' runs after 'from' has finished
+    void addEdge(NodeId from, NodeId to);
+
+    // runs all nodes on the pool: the returned future becomes ready when all nodes have finished,
+    // it holds the first exception thrown by a node (successors of a failed run aren't executed any more)
+    TaskFuture<void> run(ThreadPool& pool);
+
+    // getter
+    std::size_t size() const;
+    std::size_t criticalPath() const;   // length of the longest path through the graph
+
+private:
+    void prepare();
+    void runNode(NodeId id);
+    void fail(std::exception_ptr exception);
+    void finish();
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
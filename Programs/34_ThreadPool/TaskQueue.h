@@ -0,0 +1,115 @@
+// ===========================================================================
+// TaskQueue.h // Global injection queue of the Thread Pool
+// ===========================================================================
+
+#pragma once
+
+#include "Task.h"
+
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <vector>
+
+// FIFO queue of task pointers, realized as a growing ring buffer:
+// in contrast to std::queue (std::deque) no memory is allocated per element
+// once the buffer has reached its working size.
+
+class TaskQueue
+{
+private:
+    mutable std::mutex  m_mutex;
+    std::vector<Task*>  m_buffer;
+    std::size_t         m_head;
+    std::size_t         m_count;
+
+public:
+    // c'tor/d'tor
+    TaskQueue() : m_buffer(1024), m_head{}, m_count{} {}
+
+    ~TaskQueue()
+    {
+        // tasks never executed: destroying them breaks their promises
+        while (Task* task{ pop() }) {
+            delete task;
+        }
+    }
+
+    // no copying or moving
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator=(const TaskQueue&) = delete;
+    TaskQueue(TaskQueue&&) = delete;
+    TaskQueue& operator=(TaskQueue&&) = delete;
+
+    // public interface
+    void push(Task* task)
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+
+        if (m_count == m_buffer.size()) {
+            grow();
+        }
+
+        m_buffer[(m_head + m_count) % m_buffer.size()] = task;
+        ++m_count;
+    }
+
+    // enqueues a whole batch of tasks acquiring the lock only once
+    void push(std::span<Task* const> tasks)
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+
+        while (m_count + tasks.size() > m_buffer.size()) {
+            grow();
+        }
+
+        for (Task* task : tasks) {
+            m_buffer[(m_head + m_count) % m_buffer.size()] = task;
+            ++m_count;
+        }
+    }
+
+    // returns nullptr, if the queue is empty
+    Task* pop()
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+
+        if (m_count == 0) {
+            return nullptr;
+        }
+
+        Task* task{ m_buffer[m_head] };
+        m_head = (m_head + 1) % m_buffer.size();
+        --m_count;
+        return task;
+    }
+
+    bool empty() const
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+        return m_count == 0;
+    }
+
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+        return m_count;
+    }
+
+private:
+    void grow()
+    {
+        std::vector<Task*> buffer(2 * m_buffer.size());
+
+        for (std::size_t i{}; i != m_count; ++i) {
+            buffer[i] = m_buffer[(m_head + i) % m_buffer.size()];
+        }
+
+        m_buffer.swap(buffer);
+        m_head = 0;
+    }
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
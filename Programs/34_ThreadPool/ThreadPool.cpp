@@ -4,9 +4,36 @@
 
 #include "ThreadPool.h"
 
-ThreadPool::ThreadPool()
-    : m_threads_count{}, m_busy_threads{ }, m_shutdown_requested {}
-{}
+#include "../Globals/ThreadPlacement.h"
+#include "../Logger/TraceScope.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+// identifies the pool (and the worker index) the current thread belongs to
+struct WorkerContext
+{
+    const ThreadPool* m_pool{ nullptr };
+    std::size_t       m_index{};
+};
+
+static thread_local WorkerContext t_context{};
+
+// state of random victim selection
+static thread_local std::uint64_t t_random{ 0x9E3779B97F4A7C15ull ^ std::hash<std::thread::id>{}(std::this_thread::get_id()) };
+
+ThreadPool::ThreadPool(TaskQueuePolicy policy)
+    : m_pending{}, m_wakeups{}, m_sleeping_threads{},
+      m_threads_count{}, m_busy_threads{ }, m_shutdown_requested {}, m_shutdown_mode{ ShutdownMode::Drain },
+      m_grow_count{}, m_shrink_count{}, m_external_tasks{},
+      m_startTicks{}, m_startTime{}, m_timersWakeUp{}
+{
+    if (policy == TaskQueuePolicy::LockFree) {
+        m_queue.emplace<PriorityTaskQueue<LockFreeTaskQueue<>>>();
+    }
+}
 
 ThreadPool::~ThreadPool()
 {
@@ -15,31 +42,84 @@ ThreadPool::~ThreadPool()
 
 void ThreadPool::start()
 {
-    std::size_t numThreads{ std::thread::hardware_concurrency() };
+    start(ThreadPoolConfig{});
+}
+
+void ThreadPool::start(const ThreadPoolConfig& config)
+{
+    m_config = config;
+
+    std::size_t numThreads{ m_config.m_threadsCount };
+    if (numThreads == 0) {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    m_config.m_threadsCount = numThreads;
+
+    // elastic mode: slots for the maximum number of workers are allocated up front,
+    // so that stealing workers never observe a reallocation
+    std::size_t maxThreads{ std::max(numThreads, m_config.m_maxThreadsCount) };
 
     Logger::log(std::cout, "Number of available concurrent threads: ", numThreads);
 
-    m_pool.resize(numThreads);
+    m_startTicks = StatisticsClock::now();
+    m_startTime = std::chrono::steady_clock::now();
+
+    m_workers.resize(maxThreads);
+
+    for (std::size_t i{}; i != maxThreads; ++i)
+    {
+        m_workers[i] = std::make_unique<Worker>();
+    }
+
+    m_pool.resize(maxThreads);
 
     for (std::size_t i{}; i != numThreads; ++i)
     {
-        m_pool[i] = std::thread(&ThreadPool::worker, this);
+        m_workers[i]->m_active = true;
+        m_pool[i] = std::thread(&ThreadPool::worker, this, i);
     }
 
     m_threads_count = numThreads;
-    m_busy_threads = numThreads;
+
+    if (maxThreads > numThreads)
+    {
+        Logger::log(std::cout, "Elastic mode: up to ", maxThreads, " threads");
+
+        m_supervisor = std::jthread{ [this] (std::stop_token token) { supervisor(token); } };
+    }
 }
 
-void ThreadPool::stop()
+void ThreadPool::stop(ShutdownMode mode)
 {
-    // waits until threads finish their current task and shutdowns the pool
+    // Drain: waits until all pending tasks have been executed and shutdowns the pool,
+    // otherwise waits until threads finish their current task, pending tasks are destroyed
 
+    m_shutdown_mode = mode;
+
+    if (mode == ShutdownMode::CancelRunning) {
+        m_stop_source.request_stop();
+    }
+
+    // pending timers are discarded - before the workers may exit,
+    // no expired timer is scheduled after the last worker has gone
+    if (m_timerThread.joinable())
     {
-        std::lock_guard<std::mutex> guard{ m_mutex };
-        m_shutdown_requested = true;
+        m_timerThread.request_stop();
+        m_timerThread.join();
     }
 
-    m_condition.notify_all();
+    // no more workers are spawned or retired from now on
+    if (m_supervisor.joinable())
+    {
+        m_supervisor.request_stop();
+        m_supervisor.join();
+    }
+
+    m_shutdown_requested = true;
+
+    m_wakeups.fetch_add(1);
+    m_wakeups.notify_all();
 
     for (std::size_t i{}; i != m_pool.size(); ++i)
     {
@@ -48,52 +128,658 @@ void ThreadPool::stop()
             m_pool[i].join();
         }
     }
+
+    if (mode != ShutdownMode::Drain)
+    {
+        std::size_t discarded{ discardPending() };
+
+        if (discarded != 0) {
+            Logger::log(std::cout, "Discarded ", discarded, " pending tasks");
+        }
+    }
+}
+
+std::size_t ThreadPool::discardPending()
+{
+    // all workers have been joined: destroying a task breaks its promise. Continuations
+    // of the broken futures are scheduled once more - and are discarded in one of the next rounds
+    std::size_t count{};
+
+    while (ThreadPoolFunction* task{ nextTask(NoWorker) })
+    {
+        m_pending.fetch_sub(1);
+        delete task;
+        ++count;
+    }
+
+    return count;
+}
+
+void ThreadPool::schedule(ThreadPoolFunction func)
+{
+    // count task before publishing it, so that a worker never sees a negative number of tasks
+    m_pending.fetch_add(1);
+
+    ThreadPoolFunction* task{ new ThreadPoolFunction{ std::move(func) } };
+
+    stamp(task, ticks());
+
+    if (t_context.m_pool == this)
+    {
+        // submitted from inside a worker: no locking, stays cache-warm
+        m_workers[t_context.m_index]->m_deque.push(task);
+    }
+    else
+    {
+        std::visit([task] (auto& queue) { queue.push(task); }, m_queue);
+    }
+
+    // wake up one waiting thread if any
+    wakeUp();
 }
 
-void ThreadPool::worker()
+void ThreadPool::schedule(ThreadPoolFunction func, TaskPriority priority,
+    std::optional<std::chrono::steady_clock::time_point> deadline)
+{
+    if (priority == TaskPriority::Normal && !deadline.has_value()) {
+        schedule(std::move(func));
+        return;
+    }
+
+    m_pending.fetch_add(1);
+
+    ThreadPoolFunction* task{ new ThreadPoolFunction{ std::move(func) } };
+
+    stamp(task, ticks());
+
+    // prioritized tasks always take the injection queue, even when submitted by a worker
+    if (deadline.has_value()) {
+        std::visit([&] (auto& queue) { queue.push(task, priority, deadline.value()); }, m_queue);
+    }
+    else {
+        std::visit([&] (auto& queue) { queue.push(task, priority); }, m_queue);
+    }
+
+    wakeUp();
+}
+
+void ThreadPool::schedule(std::span<Task* const> tasks)
+{
+    if (tasks.empty()) {
+        return;
+    }
+
+    m_pending.fetch_add(tasks.size());
+
+    // one time stamp for the whole batch
+    if constexpr (ThreadPoolStatisticsEnabled)
+    {
+        std::uint64_t now{ ticks() };
+
+        for (Task* task : tasks) {
+            stamp(task, now);
+        }
+    }
+
+    if (t_context.m_pool == this)
+    {
+        for (Task* task : tasks) {
+            m_workers[t_context.m_index]->m_deque.push(task);
+        }
+    }
+    else
+    {
+        std::visit([tasks] (auto& queue) { queue.push(tasks); }, m_queue);
+    }
+
+    // wake up min(number of tasks, number of idle workers) threads
+    wakeUp(tasks.size());
+}
+
+void ThreadPoolDetail::dispatchContinuation(ThreadPool* pool, Task* continuation)
+{
+    if (pool == nullptr) {
+        (*continuation)();
+        delete continuation;
+        return;
+    }
+
+    pool->schedule(std::span<Task* const>{ &continuation, 1 });
+}
+
+void ThreadPool::worker(std::size_t index)
 {
     std::thread::id tid{ std::this_thread::get_id() };
 
+    Logger::setThreadName((m_config.m_namePrefix.empty() ? std::string{ "pool-worker-" } : m_config.m_namePrefix) + std::to_string(index));
+
     Logger::log(std::cout, "Started worker [", tid, "]");
 
-    std::unique_lock<std::mutex> guard{ m_mutex };
+    if (!m_config.m_cpuSets.empty())
+    {
+        const auto& cpus{ m_config.m_cpuSets[index % m_config.m_cpuSets.size()] };
+
+        if (!ThreadPlacement::setAffinity(cpus)) {
+            Logger::log(std::cout, "Worker [", tid, "]: couldn't set CPU affinity");
+        }
+    }
 
-    while (!m_shutdown_requested || (m_shutdown_requested && !m_queue.empty()))
+    if (!m_config.m_namePrefix.empty())
     {
+        if (!ThreadPlacement::setName(m_config.m_namePrefix + std::to_string(index))) {
+            Logger::log(std::cout, "Worker [", tid, "]: couldn't set thread name");
+        }
+    }
+
+    t_context = WorkerContext{ this, index };
+
+    Worker& self{ *m_workers[index] };
+
+    self.m_lastTick = ticks();
+    self.m_waited = true;
+
+    while (true)
+    {
+        if (m_shutdown_requested && m_shutdown_mode != ShutdownMode::Drain) {
+            break;
+        }
+
+        if (runNextTask(index)) {
+            if (self.m_idleSince.load(std::memory_order_relaxed) != 0) {
+                self.m_idleSince.store(0, std::memory_order_relaxed);
+            }
+            continue;
+        }
+
+        self.m_waited = true;
+
+        if (m_shutdown_requested && m_pending == 0) {
+            break;
+        }
+
+        if (self.m_retire) {
+            break;
+        }
+
+        if (self.m_idleSince.load(std::memory_order_relaxed) == 0) {
+            self.m_idleSince.store(
+                std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        }
+
+        park(index);
+    }
+
+    t_context = WorkerContext{};
+
+    self.m_exited = true;
+
+    Logger::log(std::cout, "Worker Done [", tid, "]");
+}
+
+bool ThreadPool::runNextTask(std::size_t index)
+{
+    std::unique_ptr<ThreadPoolFunction> func{ nextTask(index) };
+
+    if (!func) {
+        return false;
+    }
+
+    TraceScope scope{ "task" };
+
+    std::size_t depth{ m_pending.fetch_sub(1) };
+
+    if constexpr (ThreadPoolStatisticsEnabled)
+    {
+        Worker& self{ *m_workers[index] };
+        WorkerCounters& counters{ self.m_counters };
+
+        // idle: time between the end of the last task and the start of this one.
+        // Tasks running back to back share a time stamp: a single clock read per task
+        std::uint64_t start{ self.m_waited ? StatisticsClock::now() : self.m_lastTick };
+
+        self.m_waited = false;
+
+        counters.recordQueueWait(start > func->enqueued() ? start - func->enqueued() : 0);
+        WorkerCounters::increment(counters.m_idleTicks, start > self.m_lastTick ? start - self.m_lastTick : 0);
+        WorkerCounters::maximum(counters.m_maxQueueDepth, depth);
+
+        m_busy_threads++;
+        (*func)();
         m_busy_threads--;
 
-        m_condition.wait(guard, [this] {
-            return m_shutdown_requested || !m_queue.empty();
-        });
+        std::uint64_t end{ StatisticsClock::now() };
+
+        WorkerCounters::increment(counters.m_busyTicks, end > start ? end - start : 0);
+        WorkerCounters::increment(counters.m_tasksExecuted);
 
+        self.m_lastTick = end;
+    }
+    else
+    {
         m_busy_threads++;
+        (*func)();
+        m_busy_threads--;
+    }
+
+    return true;
+}
+
+bool ThreadPool::runPendingTask()
+{
+    // a worker waiting for a result is already counted as busy
+    std::size_t index{ t_context.m_pool == this ? t_context.m_index : NoWorker };
+
+    std::unique_ptr<ThreadPoolFunction> func{ nextTask(index) };
+
+    if (!func) {
+        return false;
+    }
+
+    TraceScope scope{ "task (waiting for a result)" };
+
+    m_pending.fetch_sub(1);
+
+    // the busy time is part of the task waiting for the result
+    if constexpr (ThreadPoolStatisticsEnabled)
+    {
+        if (index != NoWorker)
+        {
+            WorkerCounters& counters{ m_workers[index]->m_counters };
+
+            std::uint64_t start{ StatisticsClock::now() };
+
+            counters.recordQueueWait(start > func->enqueued() ? start - func->enqueued() : 0);
+            WorkerCounters::increment(counters.m_tasksExecuted);
+        }
+        else
+        {
+            m_external_tasks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    (*func)();
 
-        if (!this->m_queue.empty())
+    return true;
+}
+
+ThreadPool::ThreadPoolFunction* ThreadPool::nextTask(std::size_t index)
+{
+    // 1. high priority tasks and tasks with an expired deadline
+    if (ThreadPoolFunction* task{ std::visit([] (auto& queue) { return queue.popUrgent(); }, m_queue) }) {
+        countPop(index, &WorkerCounters::m_queuePops);
+        return task;
+    }
+
+    // 2. own deque (LIFO)
+    if (index != NoWorker) {
+        if (auto task{ m_workers[index]->m_deque.pop() }; task.has_value()) {
+            countPop(index, &WorkerCounters::m_localPops);
+            return *task;
+        }
+    }
+
+    // 3. global injection queue (priority lanes, FIFO within a lane)
+    if (ThreadPoolFunction* task{ std::visit([] (auto& queue) { return queue.pop(); }, m_queue) }) {
+        countPop(index, &WorkerCounters::m_queuePops);
+        return task;
+    }
+
+    // 4. steal from some other worker
+    ThreadPoolFunction* task{ stealTask(index) };
+
+    if (task != nullptr) {
+        countPop(index, &WorkerCounters::m_steals);
+    }
+
+    return task;
+}
+
+void ThreadPool::countPop(std::size_t index, std::atomic<std::uint64_t> WorkerCounters::* counter)
+{
+    if constexpr (ThreadPoolStatisticsEnabled)
+    {
+        if (index != NoWorker) {
+            WorkerCounters::increment(m_workers[index]->m_counters.*counter);
+        }
+    }
+}
+
+ThreadPool::ThreadPoolFunction* ThreadPool::stealTask(std::size_t index)
+{
+    std::size_t count{ m_workers.size() };
+    if (count == 0 || (count == 1 && index != NoWorker)) {
+        return nullptr;
+    }
+
+    // xorshift: pick a random victim, then probe all other workers once
+    t_random ^= t_random << 13;
+    t_random ^= t_random >> 7;
+    t_random ^= t_random << 17;
+
+    std::size_t start{ static_cast<std::size_t>(t_random % count) };
+
+    for (std::size_t i{}; i != count; ++i)
+    {
+        std::size_t victim{ (start + i) % count };
+        if (victim == index) {
+            continue;
+        }
+
+        if (auto task{ m_workers[victim]->m_deque.steal() }; task.has_value()) {
+            return *task;
+        }
+    }
+
+    return nullptr;
+}
+
+void ThreadPool::supervisor(std::stop_token token)
+{
+    // samples the load of the pool periodically
+    std::chrono::milliseconds interval{ std::max(
+        std::min(m_config.m_growThreshold, m_config.m_keepAlive) / 4, std::chrono::milliseconds{ 1 }) };
+
+    std::mutex mutex{};
+    std::condition_variable_any sleeping{};
+
+    std::chrono::steady_clock::time_point saturatedSince{};   // default value: pool not saturated
+
+    while (!token.stop_requested())
+    {
         {
-            auto func{ std::move(m_queue.front()) };
-            m_queue.pop();
+            std::unique_lock<std::mutex> guard{ mutex };
+            sleeping.wait_for(guard, token, interval, [] () { return false; });
+        }
+
+        if (token.stop_requested()) {
+            break;
+        }
 
-            guard.unlock();
+        auto now{ std::chrono::steady_clock::now() };
 
-            func();
+        // tasks are waiting and no worker is available to take them
+        bool saturated{ m_pending != 0 && m_busy_threads >= m_threads_count };
 
-            guard.lock();
+        if (!saturated) {
+            saturatedSince = {};
+        }
+        else if (saturatedSince == std::chrono::steady_clock::time_point{}) {
+            saturatedSince = now;
+        }
+        else if (now - saturatedSince >= m_config.m_growThreshold) {
+            if (m_threads_count < m_workers.size()) {
+                spawnWorker();
+            }
+            saturatedSince = now;
         }
+
+        retireIdleWorkers();
     }
+}
 
-    Logger::log(std::cout, "Worker Done [", tid, "]");
+void ThreadPool::spawnWorker()
+{
+    for (std::size_t i{}; i != m_workers.size(); ++i)
+    {
+        Worker& slot{ *m_workers[i] };
+
+        // a retired worker has to be joined before its slot can be reused
+        if (slot.m_active || (m_pool[i].joinable() && !slot.m_exited)) {
+            continue;
+        }
+
+        if (m_pool[i].joinable()) {
+            m_pool[i].join();
+        }
+
+        slot.m_idleSince = 0;
+        slot.m_retire = false;
+        slot.m_exited = false;
+        slot.m_active = true;
+
+        m_threads_count++;
+        m_grow_count++;
+
+        Logger::log(std::cout, "Growing pool: ", m_threads_count, " threads");
+
+        m_pool[i] = std::thread(&ThreadPool::worker, this, i);
+        return;
+    }
+}
+
+void ThreadPool::retireIdleWorkers()
+{
+    std::int64_t now{ std::chrono::steady_clock::now().time_since_epoch().count() };
+
+    std::int64_t keepAlive{
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(m_config.m_keepAlive).count() };
+
+    bool retired{ false };
+
+    for (std::size_t i{}; i != m_workers.size() && m_threads_count > m_config.m_threadsCount; ++i)
+    {
+        Worker& slot{ *m_workers[i] };
+
+        std::int64_t idleSince{ slot.m_idleSince };
+
+        if (slot.m_active && idleSince != 0 && now - idleSince >= keepAlive)
+        {
+            slot.m_active = false;
+            slot.m_retire = true;
+
+            m_threads_count--;
+            m_shrink_count++;
+            retired = true;
+
+            Logger::log(std::cout, "Shrinking pool: ", m_threads_count, " threads");
+        }
+    }
+
+    if (retired) {
+        m_wakeups.fetch_add(1);
+        m_wakeups.notify_all();
+    }
+}
+
+TimerHandle ThreadPool::addTimer(std::chrono::steady_clock::duration delay,
+    std::chrono::steady_clock::duration period, ThreadPoolFunction func)
+{
+    auto expiry{ std::chrono::steady_clock::now() + delay };
+
+    TimerId id{};
+    bool notify{ false };
+
+    {
+        std::lock_guard<std::mutex> guard{ m_mutexTimers };
+
+        id = m_timers.add(expiry, period, std::move(func));
+
+        if (!m_timerThread.joinable()) {
+            m_timerThread = std::jthread{ [this] (std::stop_token token) { timerProcedure(token); } };
+        }
+        else if (expiry < m_timersWakeUp) {
+            // timer thread has to be woken up only, if it would sleep too long:
+            // the earlier wake up time is its predicate
+            m_timersWakeUp = expiry;
+            notify = true;
+        }
+    }
+
+    if (notify) {
+        m_conditionTimers.notify_one();
+    }
+
+    return TimerHandle{
+        this,
+        [] (void* pool, TimerId id) { return static_cast<ThreadPool*>(pool)->cancelTimer(id); },
+        id
+    };
+}
+
+bool ThreadPool::cancelTimer(TimerId id)
+{
+    std::lock_guard<std::mutex> guard{ m_mutexTimers };
+    return m_timers.cancel(id);
+}
+
+void ThreadPool::timerProcedure(std::stop_token token)
+{
+    std::unique_lock<std::mutex> guard{ m_mutexTimers };
+
+    while (!token.stop_requested())
+    {
+        m_timersWakeUp = m_timers.empty()
+            ? std::chrono::steady_clock::time_point::max()
+            : m_timers.nextExpiry();
+
+        if (m_timers.empty()) {
+            m_conditionTimers.wait(guard, token, [this] () { return !m_timers.empty(); });
+        }
+        else {
+            // addTimer moves m_timersWakeUp forward for an earlier expiry
+            auto wakeUp{ m_timersWakeUp };
+            m_conditionTimers.wait_until(guard, token, wakeUp, [this, wakeUp] () { return m_timersWakeUp < wakeUp; });
+        }
+
+        if (token.stop_requested()) {
+            break;
+        }
+
+        // expired tasks are handed over to the workers
+        m_timers.advance(std::chrono::steady_clock::now(), [this] (ThreadPoolFunction func) {
+            schedule(std::move(func));
+        });
+    }
+}
+
+void ThreadPool::park(std::size_t index)
+{
+    // short spin first: tasks often arrive right after a worker ran out of work,
+    // and being woken up again is much more expensive than a few yields
+    for (std::size_t i{}; i != SpinRounds; ++i)
+    {
+        if (m_pending != 0 || m_shutdown_requested || m_workers[index]->m_retire) {
+            return;
+        }
+
+        std::this_thread::yield();
+    }
+
+    // event count: read the counter first, then re-check the condition,
+    // a concurrent wakeUp() will have changed the counter in the meantime
+    std::uint32_t wakeups{ m_wakeups.load() };
+
+    m_sleeping_threads++;
+
+    if (m_pending == 0 && !m_shutdown_requested && !m_workers[index]->m_retire) {
+        m_wakeups.wait(wakeups);
+    }
+
+    m_sleeping_threads--;
+}
+
+void ThreadPool::wakeUp(std::size_t count)
+{
+    std::size_t sleeping{ m_sleeping_threads };
+
+    if (sleeping != 0)
+    {
+        m_wakeups.fetch_add(1);
+
+        if (count >= sleeping) {
+            m_wakeups.notify_all();
+        }
+        else {
+            for (std::size_t i{}; i != count; ++i) {
+                m_wakeups.notify_one();
+            }
+        }
+    }
 }
 
 bool ThreadPool::empty() const
 {
-    std::lock_guard<std::mutex> guard{ m_mutex };
-    return m_queue.empty();
+    return m_pending == 0;
 }
 
 std::size_t ThreadPool::size() const
 {
-    std::lock_guard<std::mutex> guard{ m_mutex };
-    return m_queue.size();
+    return m_pending;
+}
+
+std::size_t ThreadPool::threadsCount() const
+{
+    return m_threads_count;
+}
+
+std::size_t ThreadPool::growCount() const
+{
+    return m_grow_count;
+}
+
+std::size_t ThreadPool::shrinkCount() const
+{
+    return m_shrink_count;
+}
+
+std::stop_token ThreadPool::stopToken() const
+{
+    return m_stop_source.get_token();
+}
+
+ThreadPoolStatistics ThreadPool::snapshot() const
+{
+    ThreadPoolStatistics statistics{};
+
+    statistics.m_pending = m_pending;
+    statistics.m_threadsCount = m_threads_count;
+    statistics.m_externalTasks = m_external_tasks.load(std::memory_order_relaxed);
+
+    // conversion factor, derived from the time elapsed since start
+    std::uint64_t elapsedTicks{ StatisticsClock::now() - m_startTicks };
+    auto elapsed{ std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_startTime) };
+
+    statistics.m_nanosecondsPerTick = elapsedTicks == 0 || m_startTicks == 0
+        ? 1.0
+        : static_cast<double>(elapsed.count()) / static_cast<double>(elapsedTicks);
+
+    auto toNanoseconds = [&] (std::uint64_t value) {
+        return std::chrono::nanoseconds{ static_cast<std::int64_t>(static_cast<double>(value) * statistics.m_nanosecondsPerTick) };
+    };
+
+    // slots of the workers are allocated once in start, they are never reallocated
+    statistics.m_workers.reserve(m_workers.size());
+
+    for (const auto& worker : m_workers)
+    {
+        const WorkerCounters& counters{ worker->m_counters };
+
+        WorkerStatistics values{
+            counters.m_tasksExecuted.load(std::memory_order_relaxed),
+            counters.m_localPops.load(std::memory_order_relaxed),
+            counters.m_queuePops.load(std::memory_order_relaxed),
+            counters.m_steals.load(std::memory_order_relaxed),
+            counters.m_maxQueueDepth.load(std::memory_order_relaxed),
+            toNanoseconds(counters.m_busyTicks.load(std::memory_order_relaxed)),
+            toNanoseconds(counters.m_idleTicks.load(std::memory_order_relaxed))
+        };
+
+        statistics.m_total.m_tasksExecuted += values.m_tasksExecuted;
+        statistics.m_total.m_localPops += values.m_localPops;
+        statistics.m_total.m_queuePops += values.m_queuePops;
+        statistics.m_total.m_steals += values.m_steals;
+        statistics.m_total.m_maxQueueDepth = std::max(statistics.m_total.m_maxQueueDepth, values.m_maxQueueDepth);
+        statistics.m_total.m_busyTime += values.m_busyTime;
+        statistics.m_total.m_idleTime += values.m_idleTime;
+
+        for (std::size_t bucket{}; bucket != QueueWaitBuckets; ++bucket) {
+            statistics.m_queueWait[bucket] += counters.m_queueWait[bucket].load(std::memory_order_relaxed);
+        }
+
+        statistics.m_workers.push_back(values);
+    }
+
+    return statistics;
 }
 
 // ===========================================================================
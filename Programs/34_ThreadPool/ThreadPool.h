@@ -6,30 +6,142 @@
 
 #include "../Logger/Logger.h"
 
+#include "../Globals/TimerWheel.h"
+
+#include "LockFreeTaskQueue.h"
+#include "PriorityTaskQueue.h"
+#include "Task.h"
+#include "TaskFuture.h"
+#include "TaskQueue.h"
+#include "ThreadPoolStatistics.h"
+#include "WorkStealingDeque.h"
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
 #include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stop_token>
+#include <string>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 
+// shutdown modes of ThreadPool::stop
+enum class ShutdownMode
+{
+    Drain,            // all pending tasks are executed (default)
+    DiscardPending,   // running tasks are completed, pending tasks are destroyed: their futures report broken_promise
+    CancelRunning     // as DiscardPending, additionally stop is requested on the std::stop_token of the running tasks
+};
+
+// lanes of the global injection queue
+enum class TaskQueuePolicy
+{
+    Mutex,            // mutex protected ring buffers (TaskQueue, default)
+    LockFree          // lock-free ring buffers (LockFreeTaskQueue)
+};
+
+namespace ThreadPoolDetail
+{
+    // tasks taking a std::stop_token as first parameter receive the stop token of the pool
+    template <typename TFunc, typename... TArgs>
+    concept AcceptsStopToken = std::invocable<TFunc, std::stop_token, TArgs...>;
+
+    template <typename TFunc, typename... TArgs>
+    using TaskResultType = typename std::conditional_t<AcceptsStopToken<TFunc, TArgs...>,
+        std::invoke_result<TFunc, std::stop_token, TArgs...>,
+        std::invoke_result<TFunc, TArgs...>>::type;
+}
+
+// start parameters of a thread pool
+struct ThreadPoolConfig
+{
+    std::size_t                             m_threadsCount{};   // 0: std::thread::hardware_concurrency()
+    std::vector<std::vector<std::size_t>>   m_cpuSets{};        // worker i is bound to m_cpuSets[i % size] - empty: no binding
+    std::string                             m_namePrefix{};     // worker i is named "<prefix><i>" - empty: no naming
+
+    // elastic mode: the pool starts with m_threadsCount workers (the minimum) and grows up to m_maxThreadsCount,
+    // whenever tasks are waiting while all workers have been busy for m_growThreshold (e.g. blocked on I/O).
+    // Additional workers idle for m_keepAlive retire.
+    std::size_t                             m_maxThreadsCount{};  // greater than m_threadsCount: elastic mode
+    std::chrono::milliseconds               m_growThreshold{ 50 };
+    std::chrono::milliseconds               m_keepAlive{ 5'000 };
+};
+
 class ThreadPool
 {
-    using ThreadPoolFunction = std::move_only_function<void()>;
+    using ThreadPoolFunction = Task;
+
+    friend void ThreadPoolDetail::dispatchContinuation(ThreadPool* pool, Task* continuation);
+    friend class TaskGraph;
 
 private:
-    mutable std::mutex              m_mutex;
-    std::condition_variable         m_condition;
-    std::vector<std::thread>        m_pool;
-    std::queue<ThreadPoolFunction>  m_queue;
-    std::size_t                     m_threads_count;
-    std::size_t                     m_busy_threads;
-    bool                            m_shutdown_requested;
+    // per worker state: tasks submitted from inside a worker are pushed onto its own deque,
+    // idle workers steal from the deques of other workers
+    struct alignas(std::hardware_destructive_interference_size) Worker
+    {
+        WorkStealingDeque<ThreadPoolFunction*>  m_deque;
+
+        // elastic mode
+        std::atomic<std::int64_t>               m_idleSince{};   // steady_clock ticks, 0: not idle
+        std::atomic<bool>                       m_retire{};      // set by the supervisor
+        std::atomic<bool>                       m_exited{};      // set by the worker thread
+        bool                                    m_active{};      // slot occupied, accessed by start and supervisor only
+
+        // statistics, written by the worker thread only
+        WorkerCounters                          m_counters;
+        std::uint64_t                           m_lastTick{};    // end of the last task (or start of the worker)
+        bool                                    m_waited{};      // worker ran out of tasks since m_lastTick
+    };
+
+    static constexpr std::size_t NoWorker{ static_cast<std::size_t>(-1) };
+    static constexpr std::size_t SpinRounds{ 64 };   // before an idle worker parks
+
+    std::vector<std::thread>                         m_pool;
+    std::vector<std::unique_ptr<Worker>>             m_workers;
+    std::variant<PriorityTaskQueue<TaskQueue>,
+        PriorityTaskQueue<LockFreeTaskQueue<>>>      m_queue;        // global injection queue (external addTask calls), see TaskQueuePolicy
+    std::atomic<std::size_t>                         m_pending;      // enqueued, but not yet dequeued tasks
+    std::atomic<std::uint32_t>                       m_wakeups;      // idle workers are parked on this counter
+    std::atomic<std::size_t>                         m_sleeping_threads;
+    std::atomic<std::size_t>                         m_threads_count;
+    std::atomic<std::size_t>                         m_busy_threads;
+    std::atomic<bool>                                m_shutdown_requested;
+    std::atomic<ShutdownMode>                        m_shutdown_mode;
+    std::stop_source                                 m_stop_source;    // passed to tasks accepting a std::stop_token
+    ThreadPoolConfig                                 m_config;
+    std::jthread                                     m_supervisor;   // elastic mode only
+    std::atomic<std::size_t>                         m_grow_count;
+    std::atomic<std::size_t>                         m_shrink_count;
+
+    // statistics: time stamp counter and clock at start, used for the conversion of ticks into nanoseconds
+    std::atomic<std::uint64_t>                       m_external_tasks;
+    std::uint64_t                                    m_startTicks;
+    std::chrono::steady_clock::time_point            m_startTime;
+
+    // delayed and periodic tasks: timer thread is started with the first timer
+    std::mutex                                       m_mutexTimers;
+    std::condition_variable_any                      m_conditionTimers;
+    TimerWheel<ThreadPoolFunction>                   m_timers;
+    std::chrono::steady_clock::time_point            m_timersWakeUp;    // timer thread sleeps until then
+    std::jthread                                     m_timerThread;
 
 public:
     // c'tors/d'tor
-    ThreadPool();
+    explicit ThreadPool(TaskQueuePolicy policy = TaskQueuePolicy::Mutex);
     ~ThreadPool();
 
     // no copying or moving
@@ -40,21 +152,25 @@ public:
 
     // public interface
     void start();
-    void stop();
+    void start(const ThreadPoolConfig& config);
+    void stop(ShutdownMode mode = ShutdownMode::Drain);
 
+    // all addTask / submit variants: a callable taking a std::stop_token as first parameter
+    // is invoked with the stop token of the pool, stop(ShutdownMode::CancelRunning) requests it to stop
     template <typename TFunc, typename... TArgs>
     auto addTask(TFunc&& func, TArgs&&... args)
-        -> std::future<typename std::invoke_result<TFunc, TArgs...>::type>
+        -> std::future<ThreadPoolDetail::TaskResultType<TFunc, TArgs...>>
     {
-        Logger::log(std::cout, "addTask ...");
+        Logger::trace(std::cout, "addTask ...");
 
-        using ReturnType = std::invoke_result<TFunc, TArgs...>::type;
+        using ReturnType = ThreadPoolDetail::TaskResultType<TFunc, TArgs...>;
 
         auto task = std::packaged_task<ReturnType()>{
-            [func = std::forward<TFunc>(func),
+            [this,
+            func = std::forward<TFunc>(func),
             ... args = std::forward<TArgs>(args)] () mutable -> ReturnType
             {
-                return std::invoke(std::move(func), std::move(args) ...);
+                return invokeTask(std::move(func), std::move(args) ...);
             }
         };
 
@@ -63,25 +179,321 @@ public:
         // generalized lambda capture
         auto wrapper{ [task = std::move(task)] () mutable -> void { task(); } };
 
+        schedule(std::move(wrapper));
+
+        // return future from packaged_task
+        return future;
+    }
+
+    // addTask with a priority class: higher lanes are drained first.
+    // Tasks with a deadline are dispatched in earliest-deadline-first order ahead of the other tasks
+    // of their lane, and before all other tasks once their deadline has been reached.
+    template <typename TFunc, typename... TArgs>
+    auto addTask(TaskPriority priority, TFunc&& func, TArgs&&... args)
+        -> std::future<ThreadPoolDetail::TaskResultType<TFunc, TArgs...>>
+    {
+        return addTask(priority, std::nullopt, std::forward<TFunc>(func), std::forward<TArgs>(args)...);
+    }
+
+    template <typename TFunc, typename... TArgs>
+    auto addTask(TaskPriority priority, std::optional<std::chrono::steady_clock::time_point> deadline,
+        TFunc&& func, TArgs&&... args)
+        -> std::future<ThreadPoolDetail::TaskResultType<TFunc, TArgs...>>
+    {
+        Logger::trace(std::cout, "addTask (priority) ...");
+
+        using ReturnType = ThreadPoolDetail::TaskResultType<TFunc, TArgs...>;
+
+        auto task = std::packaged_task<ReturnType()>{
+            [this,
+            func = std::forward<TFunc>(func),
+            ... args = std::forward<TArgs>(args)] () mutable -> ReturnType
+            {
+                return invokeTask(std::move(func), std::move(args) ...);
+            }
+        };
+
+        auto future{ task.get_future() };
+
+        schedule([task = std::move(task)] () mutable -> void { task(); }, priority, deadline);
+
+        return future;
+    }
+
+    // same as addTask, but neither the task nor the shared state of the returned future
+    // are allocated from the heap: both are recycled by memory pools
+    template <typename TFunc, typename... TArgs>
+    auto submit(TFunc&& func, TArgs&&... args)
+        -> TaskFuture<ThreadPoolDetail::TaskResultType<TFunc, TArgs...>>
+    {
+        Logger::trace(std::cout, "submit ...");
+
+        using ReturnType = ThreadPoolDetail::TaskResultType<TFunc, TArgs...>;
+
+        TaskPromise<ReturnType> promise{ this };
+
+        auto future{ promise.getFuture() };
+
+        schedule(
+            [this,
+            promise = std::move(promise),
+            func = std::forward<TFunc>(func),
+            ... args = std::forward<TArgs>(args)] () mutable -> void
+            {
+                promise.setFromInvoke(
+                    [&] () -> ReturnType { return invokeTask(std::move(func), std::move(args)...); }
+                );
+            }
+        );
+
+        return future;
+    }
+
+    // bulk submission: enqueues a range of callables (without parameters)
+    // acquiring the lock once and waking up at most as many workers as tasks
+    template <std::ranges::input_range TRange>
+    auto addTasks(TRange&& range)
+        -> std::vector<std::future<std::invoke_result_t<std::ranges::range_value_t<TRange>&>>>
+    {
+        Logger::trace(std::cout, "addTasks ...");
+
+        using ReturnType = std::invoke_result_t<std::ranges::range_value_t<TRange>&>;
+
+        std::vector<std::future<ReturnType>> futures;
+        std::vector<Task*> tasks;
+
+        if constexpr (std::ranges::sized_range<TRange>) {
+            futures.reserve(std::ranges::size(range));
+            tasks.reserve(std::ranges::size(range));
+        }
+
+        try
+        {
+            for (auto&& func : range)
+            {
+                std::packaged_task<ReturnType()> task{};
+
+                if constexpr (std::is_lvalue_reference_v<TRange>) {
+                    task = std::packaged_task<ReturnType()>{ func };              // range is kept: copy callables
+                }
+                else {
+                    task = std::packaged_task<ReturnType()>{ std::move(func) };   // range expires: move callables
+                }
+
+                futures.push_back(task.get_future());
+                tasks.push_back(new Task{ [task = std::move(task)] () mutable -> void { task(); } });
+            }
+        }
+        catch (...)
         {
-            std::lock_guard<std::mutex> guard{ m_mutex };
-            m_queue.push(std::move(wrapper));
+            // nothing has been published yet
+            for (Task* task : tasks) {
+                delete task;
+            }
+
+            throw;
         }
 
-        // wake up one waiting thread if any
-        m_condition.notify_one();
+        schedule(tasks);
+
+        return futures;
+    }
+
+    // bulk submission: invokes func(index) for every index of [first, last),
+    // the returned future becomes ready when all invocations have been completed
+    template <std::integral TIndex, typename TFunc>
+        requires std::invocable<TFunc&, TIndex>
+    TaskFuture<void> addTasks(TIndex first, TIndex last, TFunc func)
+    {
+        Logger::trace(std::cout, "addTasks ...");
+
+        // shared by all tasks of the batch, released by the last one
+        struct Batch
+        {
+            TFunc                     m_func;
+            std::atomic<std::size_t>  m_remaining;
+            std::atomic<bool>         m_failed;
+            std::exception_ptr        m_exception;
+            TaskPromise<void>         m_promise;
+
+            void fail(std::exception_ptr exception)
+            {
+                if (!m_failed.exchange(true)) {
+                    m_exception = exception;
+                }
+            }
+
+            void done()
+            {
+                if (m_remaining.fetch_sub(1) == 1)
+                {
+                    if (m_exception) {
+                        m_promise.setException(m_exception);
+                    }
+                    else {
+                        m_promise.setValue();
+                    }
+
+                    delete this;
+                }
+            }
+        };
+
+        // a task destroyed without having been run (ShutdownMode::DiscardPending)
+        // completes the batch with a broken_promise error
+        struct BatchTask
+        {
+            Batch*  m_batch;
+            TIndex  m_index;
+
+            BatchTask(Batch* batch, TIndex index) : m_batch{ batch }, m_index{ index } {}
+
+            BatchTask(BatchTask&& other) noexcept
+                : m_batch{ std::exchange(other.m_batch, nullptr) }, m_index{ other.m_index }
+            {}
+
+            ~BatchTask()
+            {
+                if (m_batch != nullptr) {
+                    m_batch->fail(std::make_exception_ptr(std::future_error{ std::future_errc::broken_promise }));
+                    m_batch->done();
+                }
+            }
+
+            void operator()()
+            {
+                Batch* batch{ std::exchange(m_batch, nullptr) };
+
+                try
+                {
+                    std::invoke(batch->m_func, m_index);
+                }
+                catch (...)
+                {
+                    batch->fail(std::current_exception());
+                }
+
+                batch->done();
+            }
+        };
+
+        Batch* batch{ new Batch{ std::move(func), static_cast<std::size_t>(last - first), false, nullptr, TaskPromise<void>{ this } } };
+
+        auto future{ batch->m_promise.getFuture() };
+
+        if (first >= last) {
+            batch->m_promise.setValue();
+            delete batch;
+            return future;
+        }
+
+        std::size_t count{ static_cast<std::size_t>(last - first) };
+        std::vector<Task*> tasks;
+
+        try
+        {
+            tasks.reserve(count);
+
+            for (TIndex index{ first }; index != last; ++index)
+            {
+                tasks.push_back(new Task{ BatchTask{ batch, index } });
+            }
+        }
+        catch (...)
+        {
+            // nothing has been published yet: the tasks created so far complete the batch when destroyed,
+            // the missing ones are accounted for here - the last one sets the exception and releases the batch
+            batch->fail(std::current_exception());
+
+            std::size_t missing{ count - tasks.size() };
+
+            for (Task* task : tasks) {
+                delete task;
+            }
+
+            for (; missing != 0; --missing) {
+                batch->done();
+            }
+
+            throw;
+        }
+
+        schedule(tasks);
 
-        // return future from packaged_task
         return future;
     }
 
+    // helping wait: instead of blocking, the calling thread executes other queued tasks
+    // until the result is available. Tasks running on the pool can wait for other tasks
+    // without deadlocking the pool (nested / divide-and-conquer parallelism).
+    // Works both for std::future and TaskFuture objects.
+    template <typename TFuture>
+    auto waitFor(TFuture& future) -> decltype(future.get())
+    {
+        std::size_t idleRounds{};
+
+        while (!isReady(future))
+        {
+            if (runPendingTask()) {
+                idleRounds = 0;
+            }
+            else if (++idleRounds < 64) {
+                std::this_thread::yield();
+            }
+            else {
+                // nothing to help with: the result is computed by other threads
+                std::this_thread::sleep_for(std::chrono::microseconds{ 50 });
+            }
+        }
+
+        return future.get();
+    }
+
+    // executes at most one queued task in the calling thread
+    bool runPendingTask();
+
+    // runs func on the pool after 'delay' - no worker is blocked while waiting
+    template <typename TFunc>
+    TimerHandle scheduleAfter(std::chrono::steady_clock::duration delay, TFunc&& func)
+    {
+        return addTimer(delay, std::chrono::steady_clock::duration::zero(), ThreadPoolFunction{ std::forward<TFunc>(func) });
+    }
+
+    // runs func on the pool every 'period', first time after one period.
+    // If func takes longer than the period, consecutive runs may overlap.
+    template <typename TFunc>
+    TimerHandle scheduleEvery(std::chrono::steady_clock::duration period, TFunc&& func)
+    {
+        return addTimer(period, period, ThreadPoolFunction{ std::forward<TFunc>(func) });
+    }
+
+    // awaitable: 'co_await pool.schedule()' resumes the calling coroutine on a worker of the pool
+    struct ScheduleAwaiter
+    {
+        ThreadPool* m_pool;
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_pool->schedule(ThreadPoolFunction{ [handle] () { handle.resume(); } });
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    ScheduleAwaiter schedule()
+    {
+        return ScheduleAwaiter{ this };
+    }
+
     template <typename TFunc, typename... TArgs>
     auto addTaskEx(TFunc&& func, TArgs&&... args)
-        -> std::future<typename std::invoke_result<TFunc, TArgs...>::type>
+        -> std::future<ThreadPoolDetail::TaskResultType<TFunc, TArgs...>>
     {
-        Logger::log(std::cout, "addTaskEx ...");
+        Logger::trace(std::cout, "addTaskEx ...");
 
-        using ReturnType = std::invoke_result<TFunc, TArgs...>::type;
+        using ReturnType = ThreadPoolDetail::TaskResultType<TFunc, TArgs...>;
 
         std::shared_ptr<std::promise<ReturnType>> promise{
             std::make_shared<std::promise<ReturnType>>() 
@@ -89,8 +501,9 @@ public:
 
         std::future<ReturnType> future{ promise->get_future() };
 
-        m_queue.push(
-            [promise,
+        schedule(
+            [this,
+            promise,
             func = std::forward<TFunc>(func),
             ... args = std::forward<TArgs>(args)] () mutable -> void
             {
@@ -98,12 +511,12 @@ public:
                 {
                     if constexpr (std::is_void_v<ReturnType>)
                     {
-                        std::invoke(std::move(func), std::move(args)...);
+                        invokeTask(std::move(func), std::move(args)...);
                         promise->set_value();
                     }
                     else
                     {
-                        auto result{ std::invoke(std::move(func), std::move(args)...) };
+                        auto result{ invokeTask(std::move(func), std::move(args)...) };
                         promise->set_value(std::move(result));
 
                         //promise->set_value(
@@ -124,9 +537,74 @@ public:
     // getter
     bool empty() const;
     std::size_t size() const;
+    std::size_t threadsCount() const;
+    std::size_t growCount() const;
+    std::size_t shrinkCount() const;
+    std::stop_token stopToken() const;
+
+    // runtime statistics, may be called from any thread once the pool has been started (lock-free)
+    ThreadPoolStatistics snapshot() const;
 
 private:
-    void worker();
+    void schedule(ThreadPoolFunction func);
+    void schedule(ThreadPoolFunction func, TaskPriority priority,
+        std::optional<std::chrono::steady_clock::time_point> deadline);
+    void schedule(std::span<Task* const> tasks);
+    void worker(std::size_t index);
+    void supervisor(std::stop_token token);
+    void spawnWorker();
+    void retireIdleWorkers();
+    bool runNextTask(std::size_t index);
+    ThreadPoolFunction* nextTask(std::size_t index);
+    ThreadPoolFunction* stealTask(std::size_t index);
+    void countPop(std::size_t index, std::atomic<std::uint64_t> WorkerCounters::* counter);
+    void park(std::size_t index);
+    TimerHandle addTimer(std::chrono::steady_clock::duration delay,
+        std::chrono::steady_clock::duration period, ThreadPoolFunction func);
+    bool cancelTimer(TimerId id);
+    void timerProcedure(std::stop_token token);
+    void wakeUp(std::size_t count = 1);
+    std::size_t discardPending();
+
+    template <typename TFunc, typename... TArgs>
+    decltype(auto) invokeTask(TFunc&& func, TArgs&&... args) const
+    {
+        if constexpr (ThreadPoolDetail::AcceptsStopToken<TFunc, TArgs...>) {
+            return std::invoke(std::forward<TFunc>(func), m_stop_source.get_token(), std::forward<TArgs>(args)...);
+        }
+        else {
+            return std::invoke(std::forward<TFunc>(func), std::forward<TArgs>(args)...);
+        }
+    }
+
+    static void stamp(Task* task, std::uint64_t now)
+    {
+        if constexpr (ThreadPoolStatisticsEnabled) {
+            task->setEnqueued(now);
+        }
+    }
+
+    static std::uint64_t ticks()
+    {
+        if constexpr (ThreadPoolStatisticsEnabled) {
+            return StatisticsClock::now();
+        }
+        else {
+            return 0;
+        }
+    }
+
+    template <typename T>
+    static bool isReady(const std::future<T>& future)
+    {
+        return future.wait_for(std::chrono::seconds::zero()) == std::future_status::ready;
+    }
+
+    template <typename T>
+    static bool isReady(const TaskFuture<T>& future)
+    {
+        return future.isReady();
+    }
 };
 
 
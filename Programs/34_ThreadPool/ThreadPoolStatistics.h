@@ -0,0 +1,143 @@
+// ===========================================================================
+// ThreadPoolStatistics.h // Runtime statistics of the Thread Pool
+// ===========================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define THREADPOOL_HAS_RDTSC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define THREADPOOL_HAS_RDTSC
+#endif
+
+// Every worker owns a cache line aligned block of counters. A counter is written by its worker only
+// (plain relaxed load and store, no read-modify-write), snapshot() reads them from any thread.
+// Time stamps are taken with the time stamp counter of the CPU (a few nanoseconds),
+// they are converted into nanoseconds when a snapshot is taken.
+// Compile-time switch: defining THREADPOOL_NO_STATISTICS removes the instrumentation of the pool.
+
+#if defined(THREADPOOL_NO_STATISTICS)
+inline constexpr bool ThreadPoolStatisticsEnabled{ false };
+#else
+inline constexpr bool ThreadPoolStatisticsEnabled{ true };
+#endif
+
+struct StatisticsClock
+{
+    static std::uint64_t now()
+    {
+#if defined(THREADPOOL_HAS_RDTSC)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+};
+
+// queue wait times: bucket i counts waits of less than 2^i ticks (and at least 2^(i-1) ticks)
+inline constexpr std::size_t QueueWaitBuckets{ 64 };
+
+// counters of a single worker, written by the worker thread only
+struct alignas(std::hardware_destructive_interference_size) WorkerCounters
+{
+    std::atomic<std::uint64_t>                             m_tasksExecuted{};
+    std::atomic<std::uint64_t>                             m_localPops{};       // own deque
+    std::atomic<std::uint64_t>                             m_queuePops{};       // global injection queue
+    std::atomic<std::uint64_t>                             m_steals{};
+    std::atomic<std::uint64_t>                             m_maxQueueDepth{};   // pending tasks, seen when taking a task
+    std::atomic<std::uint64_t>                             m_busyTicks{};
+    std::atomic<std::uint64_t>                             m_idleTicks{};
+    std::array<std::atomic<std::uint64_t>, QueueWaitBuckets> m_queueWait{};
+
+    static void increment(std::atomic<std::uint64_t>& counter, std::uint64_t value = 1)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static void maximum(std::atomic<std::uint64_t>& counter, std::uint64_t value)
+    {
+        if (value > counter.load(std::memory_order_relaxed)) {
+            counter.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    void recordQueueWait(std::uint64_t ticks)
+    {
+        std::size_t bucket{ std::min<std::size_t>(std::bit_width(ticks), QueueWaitBuckets - 1) };
+        increment(m_queueWait[bucket]);
+    }
+};
+
+// values of a single worker (or the sum of all workers)
+struct WorkerStatistics
+{
+    std::uint64_t              m_tasksExecuted{};
+    std::uint64_t              m_localPops{};
+    std::uint64_t              m_queuePops{};
+    std::uint64_t              m_steals{};
+    std::uint64_t              m_maxQueueDepth{};
+    std::chrono::nanoseconds   m_busyTime{};
+    std::chrono::nanoseconds   m_idleTime{};
+};
+
+// aggregated snapshot, returned by ThreadPool::snapshot()
+struct ThreadPoolStatistics
+{
+    WorkerStatistics                               m_total{};
+    std::vector<WorkerStatistics>                  m_workers{};
+    std::uint64_t                                  m_externalTasks{};   // executed by waitFor outside of the pool
+    std::size_t                                    m_pending{};
+    std::size_t                                    m_threadsCount{};
+    std::array<std::uint64_t, QueueWaitBuckets>    m_queueWait{};       // histogram, see QueueWaitBuckets
+    double                                         m_nanosecondsPerTick{};
+
+    // upper limit of bucket i
+    std::chrono::nanoseconds queueWaitLimit(std::size_t bucket) const
+    {
+        double ticks{ static_cast<double>(std::uint64_t{ 1 } << std::min<std::size_t>(bucket, 63)) };
+        return std::chrono::nanoseconds{ static_cast<std::int64_t>(ticks * m_nanosecondsPerTick) };
+    }
+
+    // queue wait time not exceeded by the given fraction (0.0 .. 1.0) of all tasks,
+    // precise up to a factor of 2 (the upper limit of the bucket is reported)
+    std::chrono::nanoseconds queueWaitPercentile(double fraction) const
+    {
+        std::uint64_t count{};
+        for (std::uint64_t value : m_queueWait) {
+            count += value;
+        }
+
+        if (count == 0) {
+            return std::chrono::nanoseconds::zero();
+        }
+
+        std::uint64_t rank{ static_cast<std::uint64_t>(fraction * static_cast<double>(count - 1)) + 1 };
+
+        std::uint64_t seen{};
+        for (std::size_t bucket{}; bucket != QueueWaitBuckets; ++bucket)
+        {
+            seen += m_queueWait[bucket];
+            if (seen >= rank) {
+                return queueWaitLimit(bucket);
+            }
+        }
+
+        return queueWaitLimit(QueueWaitBuckets - 1);
+    }
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
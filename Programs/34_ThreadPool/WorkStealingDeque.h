@@ -0,0 +1,172 @@
+// ===========================================================================
+// WorkStealingDeque.h // Chase-Lev Work Stealing Deque
+// ===========================================================================
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// Chase-Lev deque (see "Correct and Efficient Work-Stealing for Weak Memory Models",
+// Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013):
+// The owner thread pushes and pops at the bottom end (LIFO),
+// any other thread may steal from the top end (FIFO).
+// Elements are read racily by thieves, so they must be trivially copyable (e.g. pointers).
+
+template <typename T>
+class WorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque requires trivially copyable elements");
+
+private:
+    class Buffer
+    {
+    private:
+        std::int64_t                    m_capacity;
+        std::int64_t                    m_mask;
+        std::unique_ptr<std::atomic<T>[]> m_data;
+
+    public:
+        explicit Buffer(std::int64_t capacity)
+            : m_capacity{ capacity }, m_mask{ capacity - 1 }, m_data{ new std::atomic<T>[static_cast<std::size_t>(capacity)] }
+        {}
+
+        std::int64_t capacity() const { return m_capacity; }
+
+        void store(std::int64_t index, T item)
+        {
+            m_data[index & m_mask].store(item, std::memory_order_relaxed);
+        }
+
+        T load(std::int64_t index) const
+        {
+            return m_data[index & m_mask].load(std::memory_order_relaxed);
+        }
+
+        Buffer* grow(std::int64_t bottom, std::int64_t top) const
+        {
+            Buffer* buffer{ new Buffer{ 2 * m_capacity } };
+            for (std::int64_t i{ top }; i != bottom; ++i) {
+                buffer->store(i, load(i));
+            }
+            return buffer;
+        }
+    };
+
+    static constexpr std::size_t CacheLineSize{ std::hardware_destructive_interference_size };
+
+    alignas(CacheLineSize) std::atomic<std::int64_t> m_top;
+    alignas(CacheLineSize) std::atomic<std::int64_t> m_bottom;
+    alignas(CacheLineSize) std::atomic<Buffer*>      m_buffer;
+
+    // retired buffers may still be read by a concurrent thief,
+    // they are released together with the deque (owner thread only)
+    std::vector<std::unique_ptr<Buffer>>             m_retired;
+
+public:
+    // c'tor/d'tor - capacity must be a power of two
+    explicit WorkStealingDeque(std::int64_t capacity = 1024)
+        : m_top{}, m_bottom{}, m_buffer{ new Buffer{ capacity } }
+    {}
+
+    ~WorkStealingDeque()
+    {
+        delete m_buffer.load();
+    }
+
+    // no copying or moving
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    WorkStealingDeque(WorkStealingDeque&&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+    // owner only
+    void push(T item)
+    {
+        std::int64_t bottom{ m_bottom.load(std::memory_order_relaxed) };
+        std::int64_t top{ m_top.load(std::memory_order_acquire) };
+        Buffer* buffer{ m_buffer.load(std::memory_order_relaxed) };
+
+        if (bottom - top > buffer->capacity() - 1) {
+            Buffer* bigger{ buffer->grow(bottom, top) };
+            m_retired.emplace_back(buffer);
+            m_buffer.store(bigger, std::memory_order_release);
+            buffer = bigger;
+        }
+
+        buffer->store(bottom, item);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    // owner only
+    std::optional<T> pop()
+    {
+        std::int64_t bottom{ m_bottom.load(std::memory_order_relaxed) - 1 };
+        Buffer* buffer{ m_buffer.load(std::memory_order_relaxed) };
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t top{ m_top.load(std::memory_order_relaxed) };
+
+        if (top > bottom) {
+            // deque was empty
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        std::optional<T> item{ buffer->load(bottom) };
+
+        if (top == bottom) {
+            // last element: race against thieves
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = std::nullopt;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    // any thread
+    std::optional<T> steal()
+    {
+        std::int64_t top{ m_top.load(std::memory_order_acquire) };
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t bottom{ m_bottom.load(std::memory_order_acquire) };
+
+        if (top >= bottom) {
+            return std::nullopt;
+        }
+
+        Buffer* buffer{ m_buffer.load(std::memory_order_acquire) };
+        T item{ buffer->load(top) };
+
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return std::nullopt;   // lost race against owner or another thief
+        }
+
+        return item;
+    }
+
+    // getter (approximate while other threads are active)
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    std::size_t size() const
+    {
+        std::int64_t bottom{ m_bottom.load(std::memory_order_relaxed) };
+        std::int64_t top{ m_top.load(std::memory_order_relaxed) };
+        return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+    }
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -5,6 +5,8 @@
 #include "../Logger/Logger.h"
 #include "../Logger/ScopedTimer.h"
 
+#include "../34_ThreadPool/ThreadPool.h"
+
 #include <algorithm>
 #include <chrono>
 #include <future>
@@ -49,6 +51,41 @@ auto par_count_if(It first, It last, Pred pred) {
 
 // ===========================================================================
 
+// same algorithm, but running on a thread pool instead of spawning a thread per split:
+// waitFor executes other splits while the result of the left half isn't available
+
+template <typename It, typename Pred>
+auto par_count_if_pool(ThreadPool& pool, It first, It last, Pred pred, size_t chunk_sz) {
+
+    auto n = static_cast<size_t>(std::distance(first, last));
+    if (n <= chunk_sz)
+        return std::count_if(first, last, pred);
+
+    auto middle = std::next(first, n / 2);
+
+    auto future = pool.submit(
+        [=, &pool, &pred] {
+            return par_count_if_pool(pool, first, middle, pred, chunk_sz);
+        }
+    );
+
+    auto num = par_count_if_pool(pool, middle, last, pred, chunk_sz);
+
+    return num + pool.waitFor(future);
+}
+
+template <typename It, typename Pred>
+auto par_count_if_pool(ThreadPool& pool, It first, It last, Pred pred) {
+
+    const auto size{ static_cast<size_t>(std::distance(first, last)) };
+    const auto numCores{ std::thread::hardware_concurrency() };
+    const auto chunkSize{ std::max(size / numCores * 4, size_t{ 1000 }) };
+
+    return par_count_if_pool(pool, first, last, pred, chunkSize);
+}
+
+// ===========================================================================
+
 static auto setup_test_data(size_t n) {
 
     std::vector<int> src(n);
@@ -88,12 +125,40 @@ static void test_count_if_par(size_t size) {
     Logger::log(std::cout, "Found ", count, " numbers.");
 }
 
+static void test_count_if_pool(size_t size) {
+
+    auto&& [numbers, func] = setup_test_data(size);
+
+    ThreadPool pool{};
+    pool.start();
+
+    Logger::enableLogging(false);
+
+    {
+        ScopedTimer watch;
+
+        auto count = par_count_if_pool<std::vector<int>::iterator>(
+            pool,
+            numbers.begin(),
+            numbers.end(),
+            func
+        );
+
+        Logger::logAbs(std::cout, "Found ", count, " numbers.");
+    }
+
+    Logger::enableLogging(true);
+
+    pool.stop();
+}
+
 void test_count_if() {
 
     size_t const Size = 50'000'000;
 
     test_count_if_seq(Size);
     test_count_if_par(Size);
+    test_count_if_pool(Size);
 }
 
 // ===========================================================================
@@ -4,6 +4,7 @@
 
 #include "../Logger/Logger.h"
 #include "../Logger/ScopedTimer.h"
+#include "../Logger/TraceScope.h"
 
 #include "../Globals/IsPrime.h"
 
@@ -47,6 +48,7 @@ static auto parallel_transform(SrcIt first, SrcIt last, DstIt dst, TFunc&& func)
                     std::launch::async,
                     [=]() {
                         // Logger::log(std::cout, "Chunk: ", start, " to ", stop);
+                        TraceScope scope{ "parallel_transform chunk" };
                         std::transform(first + start, first + stop, dst + start, func);
                     }
                 )
@@ -69,6 +71,7 @@ static auto parallel_transform (SrcIt first, SrcIt last, DstIt dst, TFunc&& func
 
     const auto n = static_cast<size_t>(std::distance(first, last));
     if (n <= chunkSize) {
+        TraceScope scope{ "parallel_transform chunk (divide-conquer)" };
         std::transform(first, last, dst, func);
         return;
     }
@@ -304,6 +307,26 @@ static void test_transform_primes_parallel_div_con(size_t from, size_t to, size_
     Logger::log(std::cout, "Found ", count, " primes parallel (divide-conquer)");
 }
 
+// ===========================================================================
+// timeline of the chunks: load imbalance between the tasks (chrome://tracing, https://ui.perfetto.dev)
+
+void test_transform_primes_traced(size_t from, size_t to, size_t chunkSize) {
+
+    auto [src, dst, func] = setup_primes_calculation(from, to);
+
+    Tracing::enable(true);
+
+    parallel_transform(src.begin(), src.end(), dst.begin(), func);
+
+    parallel_transform(src.begin(), src.end(), dst.begin(), func, chunkSize);
+
+    Tracing::enable(false);
+
+    if (Tracing::dumpToFile("parallel_transform_trace.json")) {
+        Logger::log(std::cout, "Trace written to parallel_transform_trace.json");
+    }
+}
+
 // ===========================================================================
 // Snippets for Benchmark.com
 
@@ -443,6 +466,7 @@ void test_transform() {
     // test_transform_primes_01();
     // test_transform_primes_02();
     // test_transform_using_sleeps();
+    // test_transform_primes_traced(Start, End, ChunkSize);
     test_transform_example_from_book();
 }
 
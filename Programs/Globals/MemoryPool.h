@@ -0,0 +1,158 @@
+// ===========================================================================
+// MemoryPool.h // Recycling fixed-size blocks
+// ===========================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Fixed-size block allocator: every thread keeps a small cache of free blocks,
+// surplus blocks are handed over to a global list in batches.
+// In a steady state (e.g. tasks allocated by a producer and released by the workers)
+// neither malloc nor the global mutex is touched for most of the allocations.
+
+template <std::size_t BlockSize>
+class BlockPool
+{
+private:
+    union Block
+    {
+        Block*    m_next;
+        alignas(std::max_align_t) std::byte m_data[BlockSize];
+    };
+
+    static constexpr std::size_t BatchSize{ 64 };
+
+    struct Batch
+    {
+        Block*       m_head;
+        std::size_t  m_count;
+    };
+
+    struct Global
+    {
+        std::mutex          m_mutex;
+        std::vector<Batch>  m_batches;   // free blocks handed over by the threads
+        std::vector<Block*> m_slabs;     // memory obtained from the system
+
+        ~Global()
+        {
+            for (Block* slab : m_slabs) {
+                ::operator delete(slab);
+            }
+        }
+    };
+
+    struct Cache
+    {
+        Block*       m_head{ nullptr };
+        std::size_t  m_count{};
+
+        ~Cache()
+        {
+            // thread terminates: give remaining blocks back
+            if (m_count != 0) {
+                Global& pool{ global() };
+                std::lock_guard<std::mutex> guard{ pool.m_mutex };
+                pool.m_batches.push_back(Batch{ m_head, m_count });
+            }
+        }
+    };
+
+    static Global& global()
+    {
+        static Global instance{};
+        return instance;
+    }
+
+    static Cache& cache()
+    {
+        thread_local Cache instance{};
+        return instance;
+    }
+
+    static void refill(Cache& cache)
+    {
+        Global& pool{ global() };
+
+        {
+            std::lock_guard<std::mutex> guard{ pool.m_mutex };
+            if (!pool.m_batches.empty()) {
+                Batch batch{ pool.m_batches.back() };
+                pool.m_batches.pop_back();
+                cache.m_head = batch.m_head;
+                cache.m_count = batch.m_count;
+                return;
+            }
+        }
+
+        // no free blocks available: allocate a new slab
+        Block* slab{ static_cast<Block*>(::operator new(sizeof(Block) * BatchSize)) };
+
+        for (std::size_t i{}; i != BatchSize; ++i) {
+            slab[i].m_next = (i + 1 != BatchSize) ? &slab[i + 1] : nullptr;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard{ pool.m_mutex };
+            pool.m_slabs.push_back(slab);
+        }
+
+        cache.m_head = slab;
+        cache.m_count = BatchSize;
+    }
+
+    static void release(Cache& cache)
+    {
+        // keep one batch, hand over the other one
+        Block* head{ cache.m_head };
+        Block* last{ head };
+        for (std::size_t i{ 1 }; i != BatchSize; ++i) {
+            last = last->m_next;
+        }
+
+        cache.m_head = last->m_next;
+        cache.m_count -= BatchSize;
+        last->m_next = nullptr;
+
+        Global& pool{ global() };
+        std::lock_guard<std::mutex> guard{ pool.m_mutex };
+        pool.m_batches.push_back(Batch{ head, BatchSize });
+    }
+
+public:
+    static void* allocate()
+    {
+        Cache& local{ cache() };
+
+        if (local.m_head == nullptr) {
+            refill(local);
+        }
+
+        Block* block{ local.m_head };
+        local.m_head = block->m_next;
+        --local.m_count;
+        return block;
+    }
+
+    static void deallocate(void* ptr)
+    {
+        Cache& local{ cache() };
+
+        Block* block{ static_cast<Block*>(ptr) };
+        block->m_next = local.m_head;
+        local.m_head = block;
+        ++local.m_count;
+
+        if (local.m_count == 2 * BatchSize) {
+            release(local);
+        }
+    }
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -0,0 +1,107 @@
+// ===========================================================================
+// QueueBenchmark.h // Throughput of blocking producer / consumer queues
+// ===========================================================================
+
+#pragma once
+
+#include "../Logger/Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// 'producers' threads push NumItems ints into a TQueue, 'consumers' threads pop them -
+// every consumer takes exactly its share. The sum of all items checks for lost items.
+// BatchSize 1: push / pop (or waitAndPop), otherwise push_range / pop_n with batches of BatchSize.
+// Logging is disabled while the threads are running.
+
+namespace QueueBenchmark
+{
+    constexpr std::size_t NumItems{ 1 << 20 };     // divisible by 1, 4 and 16
+
+    template<typename TQueue>
+    void popItem(TQueue& queue, int& item)
+    {
+        if constexpr (requires { queue.waitAndPop(item); }) {
+            queue.waitAndPop(item);
+        }
+        else {
+            queue.pop(item);
+        }
+    }
+
+    template<typename TQueue, std::size_t BatchSize = 1>
+    void run(std::string_view name, std::size_t producers, std::size_t consumers)
+    {
+        TQueue queue{};
+
+        std::atomic<long long> sum{};
+
+        Logger::enableLogging(false);
+
+        const auto begin{ std::chrono::steady_clock::now() };
+        {
+            std::vector<std::jthread> threads;
+
+            for (std::size_t producer{}; producer != producers; ++producer) {
+                threads.emplace_back([&, producer] () {
+                    std::vector<int> batch;
+                    for (std::size_t i{ producer }; i < NumItems; i += producers) {
+                        if constexpr (BatchSize == 1) {
+                            queue.push(static_cast<int>(i));
+                        }
+                        else {
+                            batch.push_back(static_cast<int>(i));
+                            if (batch.size() == BatchSize) {
+                                queue.push_range(batch.begin(), batch.end());
+                                batch.clear();
+                            }
+                        }
+                    }
+                    if constexpr (BatchSize != 1) {
+                        queue.push_range(batch.begin(), batch.end());
+                    }
+                });
+            }
+
+            for (std::size_t consumer{}; consumer != consumers; ++consumer) {
+                threads.emplace_back([&] () {
+                    std::vector<int> batch(BatchSize);
+                    long long partialSum{};
+                    for (std::size_t remaining{ NumItems / consumers }; remaining != 0; ) {
+                        std::size_t count{ 1 };
+                        if constexpr (BatchSize == 1) {
+                            popItem(queue, batch[0]);
+                        }
+                        else {
+                            count = queue.pop_n(batch.begin(), std::min(BatchSize, remaining));
+                        }
+                        for (std::size_t i{}; i != count; ++i) {
+                            partialSum += batch[i];
+                        }
+                        remaining -= count;
+                    }
+                    sum += partialSum;
+                });
+            }
+        }   // joins
+        const auto end{ std::chrono::steady_clock::now() };
+
+        Logger::enableLogging(true);
+
+        const auto msecs{ std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() };
+        const long long expected{ static_cast<long long>(NumItems) * (NumItems - 1) / 2 };
+
+        Logger::log(std::cout, name, " - batch size ", BatchSize, " - ", producers, ":", consumers, ": ", msecs, " msecs, ",
+            NumItems / std::max<long long>(msecs, 1), " items/msec", (sum == expected) ? "" : " - WRONG RESULT");
+    }
+}
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -0,0 +1,87 @@
+// ===========================================================================
+// ThreadPlacement.cpp
+// ===========================================================================
+
+#include "ThreadPlacement.h"
+
+#if defined(_WIN32)
+
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+bool ThreadPlacement::setAffinity(std::span<const std::size_t> cpus)
+{
+    DWORD_PTR mask{};
+
+    for (std::size_t cpu : cpus) {
+        if (cpu < 8 * sizeof(DWORD_PTR)) {
+            mask |= DWORD_PTR{ 1 } << cpu;
+        }
+    }
+
+    if (mask == 0) {
+        return false;
+    }
+
+    return ::SetThreadAffinityMask(::GetCurrentThread(), mask) != 0;
+}
+
+bool ThreadPlacement::setName(const std::string& name)
+{
+    std::wstring wideName{ name.begin(), name.end() };
+
+    return SUCCEEDED(::SetThreadDescription(::GetCurrentThread(), wideName.c_str()));
+}
+
+#elif defined(__linux__)
+
+#include <pthread.h>
+#include <sched.h>
+
+bool ThreadPlacement::setAffinity(std::span<const std::size_t> cpus)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    std::size_t count{};
+
+    for (std::size_t cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+            ++count;
+        }
+    }
+
+    if (count == 0) {
+        return false;
+    }
+
+    return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+}
+
+bool ThreadPlacement::setName(const std::string& name)
+{
+    // the kernel accepts at most 16 bytes, including the terminating '\0'
+    std::string truncated{ name.substr(0, 15) };
+
+    return ::pthread_setname_np(::pthread_self(), truncated.c_str()) == 0;
+}
+
+#else
+
+bool ThreadPlacement::setAffinity(std::span<const std::size_t>)
+{
+    return false;
+}
+
+bool ThreadPlacement::setName(const std::string&)
+{
+    return false;
+}
+
+#endif
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -0,0 +1,29 @@
+// ===========================================================================
+// ThreadPlacement.h // CPU affinity and names of threads
+// ===========================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+// Both functions apply to the calling thread - so they are typically invoked
+// at the very beginning of a thread procedure.
+// They return false, if the operating system rejected the request
+// (or the platform isn't supported) - the thread keeps running as before.
+
+class ThreadPlacement
+{
+public:
+    // binds the calling thread to the given set of logical processors
+    static bool setAffinity(std::span<const std::size_t> cpus);
+
+    // names the calling thread, the name is visible in debuggers and profilers
+    // (Linux: names are truncated to 15 characters)
+    static bool setName(const std::string& name);
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -0,0 +1,368 @@
+// ===========================================================================
+// TimerWheel.h // Hierarchical timing wheel
+// ===========================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Hierarchical timing wheel (Varghese/Lauck, as used by the classic Linux kernel timers):
+// 4 levels with 256 slots each. Level 0 holds the timers expiring within the next 256 ticks,
+// level 1 those within 256 * 256 ticks, and so on. Whenever level 0 wraps around,
+// the next slot of level 1 is cascaded (re-inserted) into level 0, etc.
+// Every slot is an intrusive doubly linked list, so inserting and cancelling a timer are O(1).
+//
+// The wheel isn't thread-safe, it is driven by its owner (timer thread, event loop).
+// Expired callbacks are handed over to a visitor, which typically forwards them to an executor.
+// Periodic callbacks are shared between their firings: the visitor receives
+// a new callback object for every firing.
+
+using TimerId = std::uint64_t;   // index of the timer node + generation, 0: no timer
+
+template <typename TCallback>
+class TimerWheel
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    static constexpr std::size_t   Levels{ 4 };
+    static constexpr std::size_t   SlotBits{ 8 };
+    static constexpr std::size_t   Slots{ std::size_t{ 1 } << SlotBits };
+    static constexpr std::size_t   SlotMask{ Slots - 1 };
+    static constexpr std::uint64_t MaxDelta{ (std::uint64_t{ 1 } << (Levels * SlotBits)) - 1 };
+
+    static constexpr std::uint32_t NoNode{ static_cast<std::uint32_t>(-1) };
+    static constexpr std::size_t   ChunkSize{ 4096 };   // nodes are allocated in chunks, they never move
+
+    enum class NodeState : std::uint8_t { Free, Pending, Firing, Cancelled };
+
+    struct Node
+    {
+        TCallback                    m_callback;
+        std::shared_ptr<TCallback>   m_periodic;       // periodic timers only
+        std::uint64_t                m_expiry{};       // tick
+        std::uint64_t                m_period{};       // ticks, 0: one-shot timer
+        std::uint32_t                m_prev{ NoNode };
+        std::uint32_t                m_next{ NoNode };
+        std::uint32_t                m_generation{ 1 };
+        std::uint16_t                m_slot{};         // level * Slots + slot
+        NodeState                    m_state{ NodeState::Free };
+    };
+
+    Clock::time_point                         m_origin;
+    Clock::duration                           m_tick;
+    std::uint64_t                             m_currentTick;   // next tick to be processed
+    std::array<std::uint32_t, Levels * Slots> m_heads;
+    std::vector<std::unique_ptr<Node[]>>      m_chunks;
+    std::vector<std::uint32_t>                m_free;
+    std::size_t                               m_count;
+
+public:
+    // c'tor
+    explicit TimerWheel(Clock::duration tick = std::chrono::milliseconds{ 1 })
+        : m_origin{ Clock::now() }, m_tick{ tick }, m_currentTick{}, m_count{}
+    {
+        m_heads.fill(NoNode);
+    }
+
+    // no copying or moving
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+    TimerWheel(TimerWheel&&) = delete;
+    TimerWheel& operator=(TimerWheel&&) = delete;
+
+    // public interface
+    // 'period' zero: one-shot timer
+    TimerId add(Clock::time_point expiry, Clock::duration period, TCallback callback)
+    {
+        if (m_count == 0) {
+            // the wheel might not have been advanced for a while
+            m_currentTick = std::max(m_currentTick, elapsedTicks(Clock::now()));
+        }
+
+        std::uint32_t index{ allocate() };
+        Node& node{ at(index) };
+
+        if (period == Clock::duration::zero()) {
+            node.m_callback = std::move(callback);
+            node.m_period = 0;
+        }
+        else {
+            node.m_periodic = std::make_shared<TCallback>(std::move(callback));
+            node.m_period = std::max<std::uint64_t>(toTicks(period), 1);
+        }
+
+        node.m_expiry = toTick(expiry);
+        node.m_state = NodeState::Pending;
+
+        insert(index);
+        ++m_count;
+
+        return (static_cast<TimerId>(node.m_generation) << 32) | index;
+    }
+
+    // returns false, if the timer has already fired (or is firing right now) or has been cancelled
+    bool cancel(TimerId id)
+    {
+        std::uint32_t index{ static_cast<std::uint32_t>(id) };
+        std::uint32_t generation{ static_cast<std::uint32_t>(id >> 32) };
+
+        if (index >= m_chunks.size() * ChunkSize) {
+            return false;
+        }
+
+        Node& node{ at(index) };
+
+        if (node.m_generation != generation) {
+            return false;
+        }
+
+        if (node.m_state == NodeState::Pending) {
+            unlink(index);
+            release(index);
+            return true;
+        }
+
+        if (node.m_state == NodeState::Firing && node.m_period != 0) {
+            node.m_state = NodeState::Cancelled;   // won't be re-armed
+            return true;
+        }
+
+        return false;
+    }
+
+    // hands all callbacks expired until 'now' to the visitor: visitor(TCallback callback)
+    template <typename TVisitor>
+    void advance(Clock::time_point now, TVisitor&& visitor)
+    {
+        std::uint64_t target{ elapsedTicks(now) };
+
+        while (m_currentTick <= target)
+        {
+            if (m_count == 0) {
+                m_currentTick = target + 1;
+                return;
+            }
+
+            // cascade the higher levels, whenever a lower level wraps around
+            for (std::size_t level{ 1 }; level != Levels; ++level)
+            {
+                if (((m_currentTick >> ((level - 1) * SlotBits)) & SlotMask) != 0) {
+                    break;
+                }
+
+                cascade(level, (m_currentTick >> (level * SlotBits)) & SlotMask);
+            }
+
+            std::size_t slot{ static_cast<std::size_t>(m_currentTick & SlotMask) };
+
+            // the visitor may add or cancel timers: always take the current head of the list
+            while (m_heads[slot] != NoNode)
+            {
+                std::uint32_t index{ m_heads[slot] };
+                Node& node{ at(index) };
+
+                unlink(index);
+
+                if (node.m_period == 0) {
+                    TCallback callback{ std::move(node.m_callback) };
+                    release(index);
+                    visitor(std::move(callback));
+                    continue;
+                }
+
+                node.m_state = NodeState::Firing;
+                visitor(TCallback{ [periodic = node.m_periodic] () { (*periodic)(); } });
+
+                if (node.m_state == NodeState::Cancelled) {
+                    release(index);
+                }
+                else {
+                    // missed periods (driver was late) are skipped
+                    node.m_state = NodeState::Pending;
+                    node.m_expiry = std::max(node.m_expiry + node.m_period, m_currentTick + 1);
+                    insert(index);
+                }
+            }
+
+            ++m_currentTick;
+        }
+    }
+
+    // point in time, when advance should be called next: the next non-empty slot of level 0,
+    // or the next cascade of the higher levels
+    Clock::time_point nextExpiry() const
+    {
+        std::uint64_t tick{ m_currentTick };
+
+        do {
+            if (m_heads[tick & SlotMask] != NoNode) {
+                break;
+            }
+            ++tick;
+        } while ((tick & SlotMask) != 0);
+
+        return m_origin + static_cast<std::int64_t>(tick) * m_tick;
+    }
+
+    // getter
+    bool empty() const { return m_count == 0; }
+
+    std::size_t size() const { return m_count; }
+
+    Clock::duration tick() const { return m_tick; }
+
+private:
+    Node& at(std::uint32_t index)
+    {
+        return m_chunks[index / ChunkSize][index % ChunkSize];
+    }
+
+    std::uint64_t toTicks(Clock::duration duration) const
+    {
+        return static_cast<std::uint64_t>((duration + m_tick - Clock::duration{ 1 }) / m_tick);   // rounded up
+    }
+
+    // expiry: rounded up, a timer never fires too early
+    std::uint64_t toTick(Clock::time_point time) const
+    {
+        return time <= m_origin ? 0 : toTicks(time - m_origin);
+    }
+
+    // current time: rounded down
+    std::uint64_t elapsedTicks(Clock::time_point time) const
+    {
+        return time <= m_origin ? 0 : static_cast<std::uint64_t>((time - m_origin) / m_tick);
+    }
+
+    std::uint32_t allocate()
+    {
+        if (m_free.empty())
+        {
+            std::uint32_t first{ static_cast<std::uint32_t>(m_chunks.size() * ChunkSize) };
+            m_chunks.push_back(std::make_unique<Node[]>(ChunkSize));
+
+            for (std::uint32_t i{ ChunkSize }; i != 0; --i) {
+                m_free.push_back(first + i - 1);
+            }
+        }
+
+        std::uint32_t index{ m_free.back() };
+        m_free.pop_back();
+        return index;
+    }
+
+    void release(std::uint32_t index)
+    {
+        Node& node{ at(index) };
+
+        node.m_callback = TCallback{};
+        node.m_periodic.reset();
+        node.m_state = NodeState::Free;
+        node.m_generation++;   // invalidates all TimerId values of this node
+
+        m_free.push_back(index);
+        --m_count;
+    }
+
+    void insert(std::uint32_t index)
+    {
+        Node& node{ at(index) };
+
+        // expired timers are processed with the next tick
+        std::uint64_t expiry{ std::max(node.m_expiry, m_currentTick) };
+        std::uint64_t delta{ std::min(expiry - m_currentTick, MaxDelta) };
+        expiry = m_currentTick + delta;
+
+        std::size_t level{};
+        while (level != Levels - 1 && delta >= (std::uint64_t{ 1 } << ((level + 1) * SlotBits))) {
+            ++level;
+        }
+
+        std::size_t slot{ level * Slots + static_cast<std::size_t>((expiry >> (level * SlotBits)) & SlotMask) };
+
+        node.m_slot = static_cast<std::uint16_t>(slot);
+        node.m_prev = NoNode;
+        node.m_next = m_heads[slot];
+
+        if (node.m_next != NoNode) {
+            at(node.m_next).m_prev = index;
+        }
+
+        m_heads[slot] = index;
+    }
+
+    void unlink(std::uint32_t index)
+    {
+        Node& node{ at(index) };
+
+        if (node.m_prev != NoNode) {
+            at(node.m_prev).m_next = node.m_next;
+        }
+        else {
+            m_heads[node.m_slot] = node.m_next;
+        }
+
+        if (node.m_next != NoNode) {
+            at(node.m_next).m_prev = node.m_prev;
+        }
+
+        node.m_prev = NoNode;
+        node.m_next = NoNode;
+    }
+
+    void cascade(std::size_t level, std::size_t slot)
+    {
+        std::uint32_t index{ m_heads[level * Slots + slot] };
+        m_heads[level * Slots + slot] = NoNode;
+
+        while (index != NoNode)
+        {
+            std::uint32_t next{ at(index).m_next };
+            insert(index);
+            index = next;
+        }
+    }
+};
+
+// cancellation handle of a timer, returned by scheduleAfter / scheduleEvery
+// (must not outlive the thread pool or event loop which created it)
+class TimerHandle
+{
+public:
+    using CancelFunction = bool (*)(void* owner, TimerId id);
+
+private:
+    void*            m_owner;
+    CancelFunction   m_cancel;
+    TimerId          m_id;
+
+public:
+    TimerHandle() : m_owner{ nullptr }, m_cancel{ nullptr }, m_id{} {}
+
+    TimerHandle(void* owner, CancelFunction cancel, TimerId id)
+        : m_owner{ owner }, m_cancel{ cancel }, m_id{ id }
+    {}
+
+    // returns true, if the timer won't fire (again)
+    bool cancel()
+    {
+        return m_owner != nullptr && m_cancel(m_owner, m_id);
+    }
+
+    bool valid() const { return m_owner != nullptr; }
+
+    TimerId id() const { return m_id; }
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
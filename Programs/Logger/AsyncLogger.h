@@ -0,0 +1,383 @@
+// ===========================================================================
+// AsyncLogger.h // Asynchronous backend of the Logger
+// ===========================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Every logging thread owns a single producer / single consumer ring of fixed size records.
+// The caller formats the message directly into the next free record (strings and numbers
+// without any stream, other types through a thread local std::ostringstream), stamps it
+// and publishes it with a single release store - no lock, no allocation.
+// A background thread collects the records of all rings, orders them by their time stamps,
+// writes them in batches (one write per target stream) and releases the slots.
+// A full ring either drops the record (counted and reported) or blocks the caller.
+
+enum class LogOverflow { Drop, Block };
+
+class AsyncLogger
+{
+public:
+    static constexpr std::size_t RecordSize{ 256 };
+    static constexpr std::size_t RingSize{ 1024 };   // records per thread, power of 2
+
+private:
+    struct Record
+    {
+        std::int64_t    m_timestamp;
+        std::ostream*   m_os;
+        std::uint32_t   m_length;
+        char            m_text[RecordSize - sizeof(std::int64_t) - sizeof(std::ostream*) - sizeof(std::uint32_t)];
+    };
+
+    static constexpr std::size_t TextSize{ sizeof(Record::m_text) };
+
+    struct ThreadBuffer
+    {
+        alignas(std::hardware_destructive_interference_size) std::atomic<std::size_t> m_head{};   // producer
+        std::size_t                                                                 m_cachedTail{};
+        std::atomic<std::uint64_t>                                                  m_dropped{};  // producer writes
+        alignas(std::hardware_destructive_interference_size) std::atomic<std::size_t> m_tail{};   // consumer
+        std::uint64_t                                                               m_reported{}; // consumer
+        std::string                                                                 m_prefix{};   // guarded by s_mutex
+        std::string                                                                 m_written{};  // consumer, copy of m_prefix
+        std::atomic<bool>                                                           m_retired{};
+        std::array<Record, RingSize>                                                m_records;
+    };
+
+    // registers the ring of a thread on its first log call, retires it at thread exit
+    struct ThreadHandle
+    {
+        std::shared_ptr<ThreadBuffer> m_buffer;
+
+        ~ThreadHandle()
+        {
+            if (m_buffer) {
+                m_buffer->m_retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    struct Entry
+    {
+        std::int64_t    m_timestamp;
+        const std::string* m_prefix;
+        const Record*   m_record;
+    };
+
+    inline static thread_local ThreadHandle                 t_handle;
+    inline static thread_local std::ostringstream           t_fallback;
+
+    inline static std::mutex                                s_mutex;
+    inline static std::condition_variable                   s_condition;
+    inline static std::vector<std::shared_ptr<ThreadBuffer>> s_buffers;
+    inline static std::jthread                              s_writer;
+    inline static std::atomic<bool>                         s_running{ false };
+    inline static std::atomic<LogOverflow>                  s_overflow{ LogOverflow::Drop };
+    inline static std::uint64_t                             s_passes{};        // guarded by s_mutex
+    inline static std::size_t                               s_flushing{};      // guarded by s_mutex
+    inline static std::chrono::milliseconds                 s_interval{ 1 };
+
+public:
+    static void start(LogOverflow overflow = LogOverflow::Drop,
+        std::chrono::milliseconds interval = std::chrono::milliseconds{ 1 })
+    {
+        std::lock_guard<std::mutex> guard{ s_mutex };
+
+        if (s_running.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        s_interval = interval;
+        s_overflow.store(overflow, std::memory_order_relaxed);
+        s_running.store(true, std::memory_order_release);
+        s_writer = std::jthread{ &AsyncLogger::writerProcedure };
+    }
+
+    // writes all pending records and terminates the background thread
+    static void stop()
+    {
+        std::jthread writer;
+        {
+            std::lock_guard<std::mutex> guard{ s_mutex };
+            s_running.store(false, std::memory_order_release);
+            writer = std::move(s_writer);
+        }
+
+        s_condition.notify_all();
+    }   // joins
+
+    // the calling thread has been renamed
+    static void setPrefix(const std::string& prefix)
+    {
+        if (t_handle.m_buffer) {
+            std::lock_guard<std::mutex> guard{ s_mutex };
+            t_handle.m_buffer->m_prefix = prefix;
+        }
+    }
+
+    static bool isRunning()
+    {
+        return s_running.load(std::memory_order_acquire);
+    }
+
+    // returns after all records logged so far by any thread have been written
+    static void flush()
+    {
+        std::unique_lock<std::mutex> guard{ s_mutex };
+
+        if (!s_running.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        // the pass running right now may have missed the latest records - wait for the next one
+        std::uint64_t target{ s_passes + 2 };
+
+        ++s_flushing;
+        s_condition.notify_all();
+        s_condition.wait(guard, [target] () { return s_passes >= target || !s_running.load(std::memory_order_relaxed); });
+        --s_flushing;
+    }
+
+    // 'prefix': line prefix of the calling thread, taken over when its ring is created
+    template<typename ... TArgs>
+    static void log(const std::string& prefix, std::ostream& os, TArgs&& ...args)
+    {
+        ThreadBuffer& buffer{ threadBuffer(prefix) };
+
+        std::size_t head{ buffer.m_head.load(std::memory_order_relaxed) };
+
+        if (head - buffer.m_cachedTail == RingSize)
+        {
+            buffer.m_cachedTail = buffer.m_tail.load(std::memory_order_acquire);
+
+            while (head - buffer.m_cachedTail == RingSize)
+            {
+                if (s_overflow.load(std::memory_order_relaxed) == LogOverflow::Drop || !isRunning()) {
+                    buffer.m_dropped.store(buffer.m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return;
+                }
+
+                s_condition.notify_all();
+                std::this_thread::yield();
+                buffer.m_cachedTail = buffer.m_tail.load(std::memory_order_acquire);
+            }
+        }
+
+        Record& record{ buffer.m_records[head & (RingSize - 1)] };
+
+        char* first{ record.m_text };
+        char* last{ record.m_text + TextSize };
+
+        ((first = append(first, last, std::forward<TArgs>(args))), ...);
+
+        record.m_length = static_cast<std::uint32_t>(first - record.m_text);
+        record.m_os = &os;
+        record.m_timestamp = std::chrono::steady_clock::now().time_since_epoch().count();
+
+        buffer.m_head.store(head + 1, std::memory_order_release);
+    }
+
+private:
+    static ThreadBuffer& threadBuffer(const std::string& prefix)
+    {
+        if (!t_handle.m_buffer) [[unlikely]]
+        {
+            t_handle.m_buffer = std::make_shared<ThreadBuffer>();
+
+            std::lock_guard<std::mutex> guard{ s_mutex };
+            t_handle.m_buffer->m_prefix = prefix;
+            s_buffers.push_back(t_handle.m_buffer);
+        }
+
+        return *t_handle.m_buffer;
+    }
+
+    // formatting: same output as operator<< with default stream flags, truncated at the end of the record
+    static char* appendText(char* first, char* last, std::string_view text)
+    {
+        std::size_t count{ std::min<std::size_t>(text.size(), static_cast<std::size_t>(last - first)) };
+        std::memcpy(first, text.data(), count);
+        return first + count;
+    }
+
+    template<typename T>
+    static char* append(char* first, char* last, T&& value)
+    {
+        using Type = std::remove_cvref_t<T>;
+
+        if constexpr (std::is_same_v<Type, char>) {
+            return appendText(first, last, std::string_view{ &value, 1 });
+        }
+        else if constexpr (std::is_convertible_v<const Type&, std::string_view>) {
+            return appendText(first, last, std::string_view{ value });
+        }
+        else if constexpr (std::is_same_v<Type, bool>) {
+            return appendText(first, last, value ? "1" : "0");
+        }
+        else if constexpr (std::is_integral_v<Type>) {
+            auto [end, error] { std::to_chars(first, last, value) };
+            return (error == std::errc{}) ? end : first;
+        }
+        else if constexpr (std::is_floating_point_v<Type>) {
+            auto [end, error] { std::to_chars(first, last, value, std::chars_format::general, 6) };
+            return (error == std::errc{}) ? end : first;
+        }
+        else {
+            t_fallback.str(std::string{});
+            t_fallback << std::forward<T>(value);
+            return appendText(first, last, t_fallback.view());
+        }
+    }
+
+    // background thread
+    static void writerProcedure(std::stop_token token)
+    {
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        std::vector<std::pair<ThreadBuffer*, std::size_t>> taken;
+        std::vector<Entry> entries;
+        std::string text;
+
+        while (true)
+        {
+            bool running{ s_running.load(std::memory_order_acquire) && !token.stop_requested() };
+
+            {
+                std::lock_guard<std::mutex> guard{ s_mutex };
+                buffers = s_buffers;
+
+                for (const auto& buffer : buffers) {
+                    if (buffer->m_written != buffer->m_prefix) {
+                        buffer->m_written = buffer->m_prefix;
+                    }
+                }
+            }
+
+            entries.clear();
+            taken.clear();
+
+            for (const auto& buffer : buffers)
+            {
+                std::size_t tail{ buffer->m_tail.load(std::memory_order_relaxed) };
+                std::size_t head{ buffer->m_head.load(std::memory_order_acquire) };
+
+
+                for (std::size_t index{ tail }; index != head; ++index) {
+                    const Record& record{ buffer->m_records[index & (RingSize - 1)] };
+                    entries.push_back(Entry{ record.m_timestamp, &buffer->m_written, &record });
+                }
+
+                taken.emplace_back(buffer.get(), head);
+            }
+
+            // the rings are ordered already, merging them
+            std::stable_sort(entries.begin(), entries.end(),
+                [] (const Entry& lhs, const Entry& rhs) { return lhs.m_timestamp < rhs.m_timestamp; }
+            );
+
+            write(entries, text);
+
+            for (auto [buffer, head] : taken) {
+                buffer->m_tail.store(head, std::memory_order_release);
+            }
+
+            reportDropped(buffers, text);
+
+            buffers.clear();
+
+            std::unique_lock<std::mutex> guard{ s_mutex };
+
+            // rings of terminated threads, read completely
+            std::erase_if(s_buffers, [] (const auto& buffer) {
+                return buffer->m_retired.load(std::memory_order_acquire) &&
+                    buffer->m_tail.load(std::memory_order_relaxed) == buffer->m_head.load(std::memory_order_acquire);
+            });
+
+            ++s_passes;
+            s_condition.notify_all();
+
+            if (!running) {
+                break;   // the last pass started after stop()
+            }
+
+            if (entries.empty() && s_flushing == 0) {
+                s_condition.wait_for(guard, s_interval);
+            }
+        }
+    }
+
+    // one write per run of consecutive records to the same stream
+    static void write(const std::vector<Entry>& entries, std::string& text)
+    {
+        std::ostream* os{ nullptr };
+
+        for (const Entry& entry : entries)
+        {
+            if (entry.m_record->m_os != os) {
+                flushText(os, text);
+                os = entry.m_record->m_os;
+            }
+
+            text += *entry.m_prefix;
+            text += '\t';
+            text.append(entry.m_record->m_text, entry.m_record->m_length);
+            text += '\n';
+        }
+
+        flushText(os, text);
+    }
+
+    static void reportDropped(const std::vector<std::shared_ptr<ThreadBuffer>>& buffers, std::string& text)
+    {
+        for (const auto& buffer : buffers)
+        {
+            std::uint64_t dropped{ buffer->m_dropped.load(std::memory_order_relaxed) };
+
+            if (dropped != buffer->m_reported)
+            {
+                text = buffer->m_written + "\t" +
+                    std::to_string(dropped - buffer->m_reported) + " log record(s) dropped\n";
+
+                buffer->m_reported = dropped;
+
+                std::ostream* os{ &std::clog };
+                flushText(os, text);
+            }
+        }
+    }
+
+    static void flushText(std::ostream* os, std::string& text)
+    {
+        if (os != nullptr && !text.empty()) {
+            os->write(text.data(), static_cast<std::streamsize>(text.size()));
+            os->flush();
+        }
+
+        text.clear();
+    }
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
@@ -0,0 +1,270 @@
+// ===========================================================================
+// LatencyHistogram.h // Named latency histograms (HDR style)
+// ===========================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Log-linear buckets as in the HdrHistogram: every power of two is split into 32 linear sub-buckets,
+// a recorded value lies within about 3% of the reported value (values below 64 ns are exact).
+// Recording is lock-free: a thread records into its own shard (threads are assigned round-robin
+// to the shards), a few relaxed atomic increments - no locking, almost no sharing of cache lines.
+// The shards are merged when the histogram is read.
+// Histograms are looked up by name once (function-local static reference), recording is done
+// with a ScopedTimer or record():
+//
+//     static LatencyHistogram& histogram{ LatencyHistogram::get("ThreadPool::task") };
+//     ScopedTimer timer{ histogram };
+
+struct LatencySummary
+{
+    std::uint64_t               m_count{};
+    std::chrono::nanoseconds    m_min{};
+    std::chrono::nanoseconds    m_mean{};
+    std::chrono::nanoseconds    m_p50{};
+    std::chrono::nanoseconds    m_p90{};
+    std::chrono::nanoseconds    m_p99{};
+    std::chrono::nanoseconds    m_p999{};
+    std::chrono::nanoseconds    m_max{};
+};
+
+class LatencyHistogram
+{
+public:
+    static constexpr std::size_t SubBucketBits{ 5 };
+    static constexpr std::size_t SubBuckets{ std::size_t{ 1 } << SubBucketBits };
+    static constexpr std::size_t MaxBits{ 42 };      // about 73 minutes, larger values are clamped
+    static constexpr std::size_t Buckets{ (MaxBits - SubBucketBits + 1) * SubBuckets };
+    static constexpr std::size_t Shards{ 8 };
+
+private:
+    struct alignas(std::hardware_destructive_interference_size) Shard
+    {
+        std::atomic<std::uint64_t>                      m_count{};
+        std::atomic<std::uint64_t>                      m_sum{};
+        std::atomic<std::uint64_t>                      m_min{ std::numeric_limits<std::uint64_t>::max() };
+        std::atomic<std::uint64_t>                      m_max{};
+        std::array<std::atomic<std::uint64_t>, Buckets> m_buckets{};
+    };
+
+    std::string                         m_name;
+    std::unique_ptr<Shard[]>            m_shards;
+
+    inline static std::atomic<std::size_t>                                   s_nextShard{};
+    inline static thread_local std::size_t                                   t_shard{ s_nextShard.fetch_add(1, std::memory_order_relaxed) % Shards };
+    inline static std::mutex                                                 s_mutex;
+    inline static std::map<std::string, std::unique_ptr<LatencyHistogram>, std::less<>> s_histograms;
+
+public:
+    // c'tor
+    explicit LatencyHistogram(std::string_view name)
+        : m_name{ name }, m_shards{ std::make_unique<Shard[]>(Shards) }
+    {}
+
+    // no copying or moving
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+    LatencyHistogram(LatencyHistogram&&) = delete;
+    LatencyHistogram& operator=(LatencyHistogram&&) = delete;
+
+    // registry: created on first use, never destroyed before the end of the program
+    static LatencyHistogram& get(std::string_view name)
+    {
+        std::lock_guard<std::mutex> guard{ s_mutex };
+
+        auto pos{ s_histograms.find(name) };
+        if (pos == s_histograms.end()) {
+            pos = s_histograms.emplace(std::string{ name }, std::make_unique<LatencyHistogram>(name)).first;
+        }
+
+        return *pos->second;
+    }
+
+    static void dumpAll(std::ostream& os)
+    {
+        std::lock_guard<std::mutex> guard{ s_mutex };
+
+        for (const auto& [name, histogram] : s_histograms) {
+            histogram->dump(os);
+        }
+    }
+
+    const std::string& name() const { return m_name; }
+
+    void record(std::chrono::nanoseconds duration)
+    {
+        std::uint64_t value{ static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0)) };
+
+        Shard& shard{ m_shards[t_shard] };
+
+        shard.m_buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+        shard.m_count.fetch_add(1, std::memory_order_relaxed);
+        shard.m_sum.fetch_add(value, std::memory_order_relaxed);
+
+        if (value < shard.m_min.load(std::memory_order_relaxed)) {
+            update(shard.m_min, value, [] (std::uint64_t lhs, std::uint64_t rhs) { return lhs < rhs; });
+        }
+
+        if (value > shard.m_max.load(std::memory_order_relaxed)) {
+            update(shard.m_max, value, [] (std::uint64_t lhs, std::uint64_t rhs) { return lhs > rhs; });
+        }
+    }
+
+    // merges the shards - concurrent recording goes on, the summary is not an atomic snapshot
+    LatencySummary summary() const
+    {
+        std::vector<std::uint64_t> buckets(Buckets);
+
+        std::uint64_t count{};
+        std::uint64_t sum{};
+        std::uint64_t min{ std::numeric_limits<std::uint64_t>::max() };
+        std::uint64_t max{};
+
+        for (std::size_t i{}; i != Shards; ++i)
+        {
+            const Shard& shard{ m_shards[i] };
+
+            for (std::size_t bucket{}; bucket != Buckets; ++bucket) {
+                buckets[bucket] += shard.m_buckets[bucket].load(std::memory_order_relaxed);
+            }
+
+            count += shard.m_count.load(std::memory_order_relaxed);
+            sum += shard.m_sum.load(std::memory_order_relaxed);
+            min = std::min(min, shard.m_min.load(std::memory_order_relaxed));
+            max = std::max(max, shard.m_max.load(std::memory_order_relaxed));
+        }
+
+        LatencySummary result{};
+
+        if (count == 0) {
+            return result;
+        }
+
+        // the buckets may count a few values more or less than 'count'
+        std::uint64_t total{};
+        for (std::uint64_t value : buckets) {
+            total += value;
+        }
+
+        auto percentile = [&] (double fraction) {
+            std::uint64_t rank{ static_cast<std::uint64_t>(fraction * static_cast<double>(total - 1)) + 1 };
+            std::uint64_t seen{};
+            for (std::size_t bucket{}; bucket != Buckets; ++bucket) {
+                seen += buckets[bucket];
+                if (seen >= rank) {
+                    return std::chrono::nanoseconds{ static_cast<std::int64_t>(std::clamp(valueOf(bucket), std::min(min, max), max)) };
+                }
+            }
+            return std::chrono::nanoseconds{ static_cast<std::int64_t>(max) };
+        };
+
+        result.m_count = count;
+        result.m_min = std::chrono::nanoseconds{ static_cast<std::int64_t>(min) };
+        result.m_mean = std::chrono::nanoseconds{ static_cast<std::int64_t>(sum / count) };
+        result.m_max = std::chrono::nanoseconds{ static_cast<std::int64_t>(max) };
+
+        if (total != 0) {
+            result.m_p50 = percentile(0.5);
+            result.m_p90 = percentile(0.9);
+            result.m_p99 = percentile(0.99);
+            result.m_p999 = percentile(0.999);
+        }
+
+        return result;
+    }
+
+    // one line: name, count and min/mean/p50/p90/p99/p999/max in microseconds
+    std::string toString() const
+    {
+        LatencySummary summary{ this->summary() };
+
+        auto micro = [] (std::chrono::nanoseconds value) {
+            return std::to_string(value.count() / 1'000) + "." + std::to_string((value.count() % 1'000) / 100);
+        };
+
+        return m_name + ": " + std::to_string(summary.m_count) + " samples [us]:" +
+            " min " + micro(summary.m_min) + ", mean " + micro(summary.m_mean) +
+            ", p50 " + micro(summary.m_p50) + ", p90 " + micro(summary.m_p90) +
+            ", p99 " + micro(summary.m_p99) + ", p999 " + micro(summary.m_p999) +
+            ", max " + micro(summary.m_max);
+    }
+
+    void dump(std::ostream& os) const
+    {
+        os << toString() << '\n';
+    }
+
+    // not synchronized with concurrent recording
+    void reset()
+    {
+        for (std::size_t i{}; i != Shards; ++i)
+        {
+            Shard& shard{ m_shards[i] };
+
+            for (auto& bucket : shard.m_buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+
+            shard.m_count.store(0, std::memory_order_relaxed);
+            shard.m_sum.store(0, std::memory_order_relaxed);
+            shard.m_min.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+            shard.m_max.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static std::size_t bucketOf(std::uint64_t value)
+    {
+        if (value < 2 * SubBuckets) {
+            return static_cast<std::size_t>(value);
+        }
+
+        std::size_t shift{ std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(value)) - SubBucketBits - 1, MaxBits - SubBucketBits - 1) };
+        std::uint64_t subBucket{ std::min<std::uint64_t>(value >> shift, 2 * SubBuckets - 1) };   // SubBuckets .. 2 * SubBuckets - 1
+
+        return (shift + 1) * SubBuckets + static_cast<std::size_t>(subBucket - SubBuckets);
+    }
+
+    // middle of the bucket
+    static std::uint64_t valueOf(std::size_t bucket)
+    {
+        if (bucket < 2 * SubBuckets) {
+            return bucket;
+        }
+
+        std::size_t shift{ bucket / SubBuckets - 1 };
+        std::uint64_t subBucket{ bucket % SubBuckets + SubBuckets };
+
+        return (subBucket << shift) + (std::uint64_t{ 1 } << shift) / 2;
+    }
+
+    template<typename TCompare>
+    static void update(std::atomic<std::uint64_t>& extremum, std::uint64_t value, TCompare compare)
+    {
+        std::uint64_t current{ extremum.load(std::memory_order_relaxed) };
+
+        while (compare(value, current) &&
+            !extremum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {}
+    }
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================
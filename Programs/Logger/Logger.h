@@ -4,42 +4,131 @@
 
 #pragma once
 
+#include "AsyncLogger.h"
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <ctime>
 #include <iostream>
 #include <map>
 #include <mutex>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <syncstream>
 #include <thread> 
+#include <utility>
+#include <vector>
+
+enum class LogLevel { Trace, Debug, Info, Warning, Error, Off };
+
+// Compile-time minimum level: calls below this level are removed completely
+// (the function body is empty, no check at runtime). Release builds drop Trace and Debug,
+// can be overridden with -DLOGGER_MIN_LEVEL=<0..5> (0: Trace, ..., 5: Off).
+#if !defined(LOGGER_MIN_LEVEL)
+#if defined(NDEBUG)
+#define LOGGER_MIN_LEVEL 2
+#else
+#define LOGGER_MIN_LEVEL 0
+#endif
+#endif
+
+inline constexpr LogLevel LoggerMinLevel{ static_cast<LogLevel>(LOGGER_MIN_LEVEL) };
 
 class Logger {
 public:
     static void enableLogging(bool enable)
     {
-        s_loggingEnabled = enable;
+        std::lock_guard<std::mutex> guard{ s_mutexLevel };
+        s_loggingEnabled.store(enable, std::memory_order_relaxed);
+        s_threshold.store(enable ? s_level : LogLevel::Off, std::memory_order_relaxed);
     }
 
     static bool isLoggingEnabled()
     {
-        return s_loggingEnabled;
+        return s_loggingEnabled.load(std::memory_order_relaxed);
+    }
+
+    // runtime level, effective for levels not removed at compile time
+    static void setLevel(LogLevel level)
+    {
+        std::lock_guard<std::mutex> guard{ s_mutexLevel };
+        s_level = level;
+        s_threshold.store(s_loggingEnabled.load(std::memory_order_relaxed) ? level : LogLevel::Off, std::memory_order_relaxed);
+    }
+
+    static LogLevel getLevel()
+    {
+        std::lock_guard<std::mutex> guard{ s_mutexLevel };
+        return s_level;
+    }
+
+    // the runtime check: a single relaxed atomic load
+    static bool isEnabled(LogLevel level)
+    {
+        return level >= s_threshold.load(std::memory_order_relaxed);
+    }
+
+    // asynchronous mode: log calls only store a record, a background thread writes them.
+    // Target streams must outlive stopAsync()
+    static void startAsync(LogOverflow overflow = LogOverflow::Drop)
+    {
+        AsyncLogger::start(overflow);
+    }
+
+    static void stopAsync()
+    {
+        AsyncLogger::stop();
+    }
+
+    static void flush()
+    {
+        AsyncLogger::flush();
     }
 
     template<typename ... TArgs>
     static void logInternal(std::ostream& os, TArgs&& ...args)
     {
+        const ThreadInfo& thread{ currentThread() };
+
+        if (AsyncLogger::isRunning()) {
+            AsyncLogger::log(thread.m_prefix, os, std::forward<TArgs>(args)...);
+            return;
+        }
+
         std::osyncstream syncStream{ os };
-        ((syncStream << getPrefix() << '\t') << ... << std::forward<TArgs>(args)) << '\n';
+        ((syncStream << thread.m_prefix << '\t') << ... << std::forward<TArgs>(args)) << '\n';
     }
 
     // log conditionally
+    template<LogLevel Level, typename ... TArgs>
+    static void log(std::ostream& os, TArgs&& ...args)
+    {
+        if constexpr (Level >= LoggerMinLevel && Level != LogLevel::Off) {
+            if (isEnabled(Level)) {
+                logInternal(os, std::forward<TArgs>(args)...);
+            }
+        }
+    }
+
     template<typename ... TArgs>
     static void log(std::ostream& os, TArgs&& ...args)
     {
-        if (!s_loggingEnabled)
-            return;
+        log<LogLevel::Info>(os, std::forward<TArgs>(args)...);
+    }
 
-        logInternal(os, std::forward<TArgs>(args)...);
+    // hot paths (per task, per event, per queue operation)
+    template<typename ... TArgs>
+    static void trace(std::ostream& os, TArgs&& ...args)
+    {
+        log<LogLevel::Trace>(os, std::forward<TArgs>(args)...);
+    }
+
+    template<typename ... TArgs>
+    static void debug(std::ostream& os, TArgs&& ...args)
+    {
+        log<LogLevel::Debug>(os, std::forward<TArgs>(args)...);
     }
 
     // log unconditionally
@@ -49,15 +138,57 @@ public:
         logInternal(os, std::forward<TArgs>(args)...);
     }
 
+    // readable thread ids: assigned once per thread, cached in a thread_local -
+    // the registry is consulted for other threads, naming and enumeration only
+    static size_t readableTID()
+    {
+        return currentThread().m_index;
+    }
+
     static size_t readableTID(const std::thread::id id)
     {
+        if (id == std::this_thread::get_id()) {
+            return readableTID();
+        }
+
+        std::lock_guard<std::mutex> guard{ s_mutexIds };
+        return registerThread(id).m_index;
+    }
+
+    // name of the calling thread, e.g. "pool-worker-3" - shown in the prefix: [4:pool-worker-3]
+    static void setThreadName(std::string_view name)
+    {
+        ThreadInfo& thread{ currentThread() };
+
+        std::lock_guard<std::mutex> guard{ s_mutexIds };
+        ThreadEntry& entry{ registerThread(std::this_thread::get_id()) };
+        entry.m_name = name;
+        thread.m_prefix = makePrefix(entry);
+
+        AsyncLogger::setPrefix(thread.m_prefix);
+    }
+
+    static std::string threadName()
+    {
+        currentThread();
+
         std::lock_guard<std::mutex> guard{ s_mutexIds };
-        if (s_mapIds.find(id) == s_mapIds.end()) {
-            s_nextIndex++;
-            s_mapIds[id] = s_nextIndex;
+        return registerThread(std::this_thread::get_id()).m_name;
+    }
+
+    // all registered threads: readable id and name
+    static std::vector<std::pair<std::size_t, std::string>> threads()
+    {
+        std::vector<std::pair<std::size_t, std::string>> result;
+        {
+            std::lock_guard<std::mutex> guard{ s_mutexIds };
+            for (const auto& [id, entry] : s_mapIds) {
+                result.emplace_back(entry.m_index, entry.m_name);
+            }
         }
 
-        return s_mapIds[id];
+        std::sort(result.begin(), result.end());
+        return result;
     }
 
     static void startWatch() {
@@ -67,34 +198,84 @@ public:
     static void stopWatchMilli(std::ostream& os) {
         std::chrono::steady_clock::time_point end{ std::chrono::steady_clock::now() };
         auto duration{ std::chrono::duration_cast<std::chrono::milliseconds>(end - s_begin).count() };
-        os << getPrefix() << '\t' << "Elapsed time: " << duration << " [milliseconds]" << std::endl;
+        logInternal(os, "Elapsed time: ", duration, " [milliseconds]");
     }
 
     static void stopWatchMicro(std::ostream& os) {
         std::chrono::steady_clock::time_point end{ std::chrono::steady_clock::now() };
         auto duration{ std::chrono::duration_cast<std::chrono::microseconds>(end - s_begin).count() };
-        os << getPrefix() << '\t' << "Elapsed time: " << duration << " [microseconds]" << std::endl;
+        logInternal(os, "Elapsed time: ", duration, " [microseconds]");
     }
 
 private:
-    static std::string getPrefix()
+    struct ThreadEntry
     {
-        std::stringstream ss;
-        std::thread::id currentThreadId{ std::this_thread::get_id() };
-        size_t tid{ readableTID(currentThreadId) };
-        std::string prefix{ "[" + std::to_string(tid) + "]: " };
-        ss << prefix;
-        return ss.str();
+        std::size_t m_index;
+        std::string m_name;
+    };
+
+    // per thread cache, removes the registry entry at thread exit (std::thread::id values are reused)
+    struct ThreadInfo
+    {
+        std::size_t m_index;
+        std::string m_prefix;
+
+        ThreadInfo() : m_index{ 0 }, m_prefix{} {}
+
+        ~ThreadInfo()
+        {
+            if (m_index != 0) {
+                std::lock_guard<std::mutex> guard{ s_mutexIds };
+                s_mapIds.erase(std::this_thread::get_id());
+            }
+        }
+    };
+
+    static ThreadInfo& currentThread()
+    {
+        if (t_thread.m_index == 0) [[unlikely]]
+        {
+            std::lock_guard<std::mutex> guard{ s_mutexIds };
+            const ThreadEntry& entry{ registerThread(std::this_thread::get_id()) };
+            t_thread.m_index = entry.m_index;
+            t_thread.m_prefix = makePrefix(entry);
+        }
+
+        return t_thread;
+    }
+
+    // s_mutexIds must be held
+    static ThreadEntry& registerThread(std::thread::id id)
+    {
+        auto [pos, inserted] { s_mapIds.try_emplace(id, ThreadEntry{ s_nextIndex + 1, std::string{} }) };
+        if (inserted) {
+            ++s_nextIndex;
+        }
+
+        return pos->second;
+    }
+
+    static std::string makePrefix(const ThreadEntry& entry)
+    {
+        if (entry.m_name.empty()) {
+            return "[" + std::to_string(entry.m_index) + "]: ";
+        }
+
+        return "[" + std::to_string(entry.m_index) + ":" + entry.m_name + "]: ";
     }
 
     // Inline static definitions to avoid missing-symbol linker errors
     // when this header is included in multiple translation units
     // Requires C++17 (inline variables).
     inline static std::chrono::steady_clock::time_point s_begin{};
-    inline static bool s_loggingEnabled{ true };
+    inline static std::atomic<bool> s_loggingEnabled{ true };
+    inline static std::atomic<LogLevel> s_threshold{ LogLevel::Trace };   // s_level, or Off when disabled
+    inline static LogLevel s_level{ LogLevel::Trace };
+    inline static std::mutex s_mutexLevel;
     inline static std::mutex s_mutexIds;
-    inline static std::map<std::thread::id, std::size_t> s_mapIds;
+    inline static std::map<std::thread::id, ThreadEntry> s_mapIds;
     inline static std::size_t s_nextIndex{ 0 };
+    inline static thread_local ThreadInfo t_thread;
 };
 
 // ===========================================================================
@@ -4,18 +4,38 @@
 
 #pragma once
 
+#include <chrono>
 #include <iostream>
 
+#include "LatencyHistogram.h"
 #include "Logger.h"
 
+// Every timer owns its start time - timers may be nested or run concurrently in several threads.
+// Default: the elapsed time is logged in milliseconds at the end of the scope.
+// Statistics mode: the elapsed time is recorded silently into a LatencyHistogram.
+
 class ScopedTimer {
+private:
+    std::chrono::steady_clock::time_point m_begin;
+    LatencyHistogram*                     m_histogram;
+
 public:
-    ScopedTimer() {
-        Logger::startWatch();
-    }
+    ScopedTimer() : m_begin{ std::chrono::steady_clock::now() }, m_histogram{ nullptr } {}
+
+    explicit ScopedTimer(LatencyHistogram& histogram)
+        : m_begin{ std::chrono::steady_clock::now() }, m_histogram{ &histogram }
+    {}
 
     ~ScopedTimer() {
-        Logger::stopWatchMilli(std::cout);
+        std::chrono::steady_clock::duration elapsed{ std::chrono::steady_clock::now() - m_begin };
+
+        if (m_histogram != nullptr) {
+            m_histogram->record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+        }
+        else {
+            auto duration{ std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() };
+            Logger::logAbs(std::cout, "Elapsed time: ", duration, " [milliseconds]");
+        }
     }
 
     // no copying or moving
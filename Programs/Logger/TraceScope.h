@@ -0,0 +1,291 @@
+// ===========================================================================
+// TraceScope.h // Timing regions exported as Chrome trace events
+// ===========================================================================
+
+#pragma once
+
+#include "Logger.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// A TraceScope marks a timing region: at its end one "complete" event (name, begin, duration,
+// thread) is appended to a buffer of the calling thread - a plain store plus a release store
+// of the event count, no lock. Buffers are chains of fixed size chunks, they never move:
+// dump() may be called while other threads are still recording.
+// The output is the JSON trace event format, it is loaded into chrome://tracing or
+// https://ui.perfetto.dev - one row per thread, named by Logger::setThreadName (before the first event).
+// Names must be string literals (only the pointer is stored).
+// Tracing is disabled by default: a disabled TraceScope costs a single relaxed atomic load.
+//
+//     Tracing::enable(true);
+//     { TraceScope scope{ "work" }; ... }
+//     Tracing::dumpToFile("trace.json");     // or Tracing::dumpAtExit("trace.json")
+
+class Tracing
+{
+private:
+    struct Event
+    {
+        const char*     m_name;
+        std::int64_t    m_begin;      // steady_clock, nanoseconds
+        std::int64_t    m_duration;
+    };
+
+    static constexpr std::size_t ChunkSize{ 4096 };
+
+    struct Chunk
+    {
+        std::array<Event, ChunkSize>    m_events;
+        std::atomic<std::size_t>        m_count{};
+        std::atomic<Chunk*>             m_next{ nullptr };
+    };
+
+    struct ThreadTrace
+    {
+        std::size_t                 m_tid{};
+        std::string                 m_name{};
+        std::unique_ptr<Chunk>      m_first{ std::make_unique<Chunk>() };
+        Chunk*                      m_last{ m_first.get() };      // owning thread only
+
+        ~ThreadTrace()
+        {
+            Chunk* chunk{ m_first.release() };
+            while (chunk != nullptr) {
+                delete std::exchange(chunk, chunk->m_next.load(std::memory_order_relaxed));
+            }
+        }
+    };
+
+    inline static std::atomic<bool>                             s_enabled{ false };
+    inline static std::mutex                                    s_mutex;
+    inline static std::vector<std::shared_ptr<ThreadTrace>>     s_threads;
+    inline static thread_local std::shared_ptr<ThreadTrace>     t_trace;
+    inline static std::string                                   s_exitPath;
+
+    struct ExitDump
+    {
+        ~ExitDump()
+        {
+            if (!s_exitPath.empty()) {
+                dumpToFile(s_exitPath);
+            }
+        }
+    };
+
+    inline static ExitDump                                      s_exitDump;   // destroyed before the members above
+
+public:
+    static void enable(bool enable)
+    {
+        s_enabled.store(enable, std::memory_order_relaxed);
+    }
+
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    static std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static void record(const char* name, std::int64_t begin, std::int64_t end)
+    {
+        ThreadTrace& trace{ threadTrace() };
+
+        Chunk* chunk{ trace.m_last };
+        std::size_t count{ chunk->m_count.load(std::memory_order_relaxed) };
+
+        if (count == ChunkSize) [[unlikely]]
+        {
+            Chunk* next{ new Chunk{} };
+            chunk->m_next.store(next, std::memory_order_release);
+            trace.m_last = chunk = next;
+            count = 0;
+        }
+
+        chunk->m_events[count] = Event{ name, begin, end - begin };
+        chunk->m_count.store(count + 1, std::memory_order_release);
+    }
+
+    // JSON trace event format, all events recorded so far
+    static void dump(std::ostream& os)
+    {
+        std::vector<std::shared_ptr<ThreadTrace>> threads;
+        {
+            std::lock_guard<std::mutex> guard{ s_mutex };
+            threads = s_threads;
+        }
+
+        os << "{\"traceEvents\":[\n";
+
+        bool first{ true };
+        auto separator = [&] () -> std::ostream& {
+            if (!first) {
+                os << ",\n";
+            }
+            first = false;
+            return os;
+        };
+
+        for (const auto& trace : threads)
+        {
+            separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << trace->m_tid
+                << ",\"args\":{\"name\":\"" << escaped(trace->m_name) << "\"}}";
+
+            for (const Chunk* chunk{ trace->m_first.get() }; chunk != nullptr; chunk = chunk->m_next.load(std::memory_order_acquire))
+            {
+                std::size_t count{ chunk->m_count.load(std::memory_order_acquire) };
+
+                for (std::size_t i{}; i != count; ++i)
+                {
+                    const Event& event{ chunk->m_events[i] };
+
+                    // microseconds with nanosecond precision
+                    separator() << "{\"name\":\"" << escaped(event.m_name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << trace->m_tid
+                        << ",\"ts\":" << event.m_begin / 1'000 << '.' << fraction(event.m_begin)
+                        << ",\"dur\":" << event.m_duration / 1'000 << '.' << fraction(event.m_duration) << '}';
+                }
+            }
+        }
+
+        os << "\n]}\n";
+    }
+
+    static bool dumpToFile(const std::string& path)
+    {
+        std::ofstream file{ path };
+        if (!file) {
+            Logger::log(std::cout, "Tracing: couldn't open ", path);
+            return false;
+        }
+
+        dump(file);
+        return static_cast<bool>(file);
+    }
+
+    // the trace is written when the program terminates (after main)
+    static void dumpAtExit(const std::string& path)
+    {
+        std::lock_guard<std::mutex> guard{ s_mutex };
+        s_exitPath = path;
+    }
+
+    // drops all events - no thread may be recording
+    static void clear()
+    {
+        std::lock_guard<std::mutex> guard{ s_mutex };
+
+        for (const auto& trace : s_threads)
+        {
+            Chunk* chunk{ trace->m_first->m_next.exchange(nullptr, std::memory_order_relaxed) };
+            while (chunk != nullptr) {
+                delete std::exchange(chunk, chunk->m_next.load(std::memory_order_relaxed));
+            }
+
+            trace->m_first->m_count.store(0, std::memory_order_relaxed);
+            trace->m_last = trace->m_first.get();
+        }
+    }
+
+private:
+    static ThreadTrace& threadTrace()
+    {
+        if (!t_trace) [[unlikely]]
+        {
+            auto trace{ std::make_shared<ThreadTrace>() };
+            trace->m_tid = Logger::readableTID();
+            trace->m_name = Logger::threadName();
+
+            if (trace->m_name.empty()) {
+                trace->m_name = "thread " + std::to_string(trace->m_tid);
+            }
+
+            std::lock_guard<std::mutex> guard{ s_mutex };
+            s_threads.push_back(trace);
+            t_trace = std::move(trace);
+        }
+
+        return *t_trace;
+    }
+
+    // JSON string contents: quotes, backslashes and control characters are escaped
+    static std::string escaped(std::string_view text)
+    {
+        std::string result;
+        result.reserve(text.size());
+
+        for (char ch : text)
+        {
+            switch (ch)
+            {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    constexpr char Hex[]{ "0123456789abcdef" };
+                    result += "\\u00";
+                    result += Hex[(ch >> 4) & 0xF];
+                    result += Hex[ch & 0xF];
+                }
+                else {
+                    result += ch;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    static std::string fraction(std::int64_t nanoseconds)
+    {
+        std::string digits{ std::to_string(nanoseconds % 1'000) };
+        return std::string(3 - digits.size(), '0') + digits;
+    }
+};
+
+class TraceScope
+{
+private:
+    const char*     m_name;
+    std::int64_t    m_begin;
+
+public:
+    explicit TraceScope(const char* name)
+        : m_name{ name }, m_begin{ Tracing::isEnabled() ? Tracing::now() : 0 }
+    {}
+
+    ~TraceScope()
+    {
+        if (m_begin != 0) {
+            Tracing::record(m_name, m_begin, Tracing::now());
+        }
+    }
+
+    // no copying or moving
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+    TraceScope(TraceScope&&) = delete;
+    TraceScope& operator=(TraceScope&&) = delete;
+};
+
+// ===========================================================================
+// End-of-File
+// ===========================================================================